@@ -1,51 +1,195 @@
 #include "AerialAssistRobot.h"
 
-AerialAssistRobot::AerialAssistRobot(void)	{
+//every cycle of every mode since boot; relative to the working directory, / on the cRIO
+static const char * TELEMETRY_LOG = "telemetry.log";
+static const char * TELEMETRY_INDEX = "telemetry.idx";
+
+/*
+ * Subsystem updates, for the scheduler
+ */
+static void update_arm(void * arm) {
+	((Arm *)arm)->update();
+}
 
+static void update_winch(void * winch) {
+	((Winch *)winch)->update();
 }
 
-void AerialAssistRobot::RobotInit(void) {
-	front_left = new Talon(FRONT_LEFT_DRIVE_PWM);
-	front_right = new Talon(FRONT_RIGHT_DRIVE_PWM);
-	rear_left = new Talon(REAR_LEFT_DRIVE_PWM);
-	rear_right = new Talon(REAR_RIGHT_DRIVE_PWM);
-	drive = new RobotDrive(front_left, rear_left, front_right, rear_right);
-	drive->SetInvertedMotor(RobotDrive::kFrontLeftMotor, false);
-	drive->SetInvertedMotor(RobotDrive::kRearLeftMotor, false);
-	drive->SetInvertedMotor(RobotDrive::kFrontRightMotor, false);
-	drive->SetInvertedMotor(RobotDrive::kRearRightMotor, false);
-	old_speed = 0.0f;
-	old_turn = 0.0f;
+static void update_winch_safety(void * winch) {
+	((Winch *)winch)->update(true);
+}
 
-	roller = new Victor(ROLLER_PWM);
-	arm_lift = new Victor(ARM_LIFT_PWM);
-	arm_floor = new DigitalInput(ARM_FLOOR_SWITCH_DIO);
-	arm_top = new DigitalInput(ARM_TOP_SWITCH_DIO);
-	arm_ball = new DigitalInput(ARM_LINE_BREAK_DIO);
-	arm_encoder = new Encoder(ARM_ENCODER_A_CHANNEL, ARM_ENCODER_B_CHANNEL, false);
+static void update_rangefinder(void * rangefinder) {
+	((Rangefinder *)rangefinder)->update();
+}
 
-	arm = new Arm(roller, arm_lift, arm_encoder, arm_floor, arm_top, arm_ball);
+static void update_display(void * display) {
+	((DiagnosticsDisplay *)display)->update();
+}
 
-	winch_motor = new Victor(WINCH_PWM);
-	winch_encoder = new Encoder(WINCH_ENCODER_A_CHANNEL, WINCH_ENCODER_B_CHANNEL);
-	winch_max_switch = new DigitalInput (WINCH_MAX_LIMIT_DIO);
+/*
+ * Everything RobotInit makes lives here rather than on the heap, down to the timers,
+ * Notifiers and tasks inside our classes; the size leaves room for the real WPILib's
+ * objects, which are bigger than the sim's (it prints how much is used). What's left on
+ * the heap is WPILib's and vxWorks' own: semaphores, and whatever their objects allocate.
+ */
+static const size_t ARENA_SIZE = 256 * 1024;
+static UINT8 arena_memory[ARENA_SIZE] __attribute__((aligned(StaticArena::CACHE_LINE)));
+static StaticArena robot_arena("robot arena", arena_memory, ARENA_SIZE);
+
+static void latch_sensors(void * sensors) {
+	((SensorFrame *)sensors)->latch();
+}
 
-	led_red_channel = new DigitalOutput(RED_LED_DIO);
-	led_green_channel = new DigitalOutput(GREEN_LED_DIO);
-	led_blue_channel = new DigitalOutput(BLUE_LED_DIO);
-	led = new DigitalLED(led_red_channel, led_green_channel, led_blue_channel);
+static void commit_outputs(void * outputs) {
+	((OutputFrame *)outputs)->commit();
+}
 
-	gear_shift = new DoubleSolenoid(GEAR_SHIFT_SOL_FORWARD, GEAR_SHIFT_SOL_REVERSE);
-	clutch = new Solenoid(CLUTCH_SOL);
+/*
+ * The autonomous routines
+ * Each step runs every cycle from its start time until its end time. See AutonTimeline.h
+ */
+typedef AutonTimeline T;
+static const float END = T::END_OF_AUTON;
+
+static const T::step MAIN_STEPS[] = {
+	{0.0f, 6.0f, T::ARCADE_DRIVE, 0.5f, -0.2f, T::ALWAYS}, //TODO: May need to compensate for drive-train turn
+	{6.0f, END, T::ARCADE_DRIVE, 0.0f, 0.0f, T::ALWAYS},
+	{0.0f, 2.5f, T::ARM_DROP_BALL_IN, 0, 0, T::ALWAYS},
+	{2.5f, 4.5f, T::ARM_MOVE_TO_BOTTOM, 0, 0, T::ALWAYS},
+	{0.0f, 0.1f, T::WINCH_WIND_BACK, 0, 0, T::ALWAYS},
+	{7.0f, 7.5f, T::WINCH_FIRE, 0, 0, T::ALWAYS},
+	//flash red twice, then hold green once we've fired
+	{5.0f, 5.5f, T::LED_COLOR, DigitalLED::RED, 0, T::ALWAYS},
+	{5.5f, 6.0f, T::LED_COLOR, DigitalLED::OFF, 0, T::ALWAYS},
+	{6.0f, 6.5f, T::LED_COLOR, DigitalLED::RED, 0, T::ALWAYS},
+	{6.5f, 7.0f, T::LED_COLOR, DigitalLED::OFF, 0, T::ALWAYS},
+	{7.0f, END, T::LED_COLOR, DigitalLED::GREEN, 0, T::ALWAYS}
+};
+
+static const T::step TWO_BALL_STEPS[] = {
+	{0.0f, 2.5f, T::ARCADE_DRIVE, -0.4f, 0.0f, T::ALWAYS},
+	{2.5f, 4.0f, T::ARCADE_DRIVE, 0.0f, 0.0f, T::ALWAYS},
+	{4.0f, END, T::ARCADE_DRIVE, 0.5f, 0.0f, T::ALWAYS},
+	{0.0f, 2.5f, T::ARM_DROP_BALL_IN, 0, 0, T::ALWAYS},
+	{2.5f, 6.0f, T::ARM_LOAD_SEQUENCE, 0, 0, T::ALWAYS},
+	{6.0f, 7.5f, T::ARM_DROP_BALL_IN, 0, 0, T::ALWAYS}, //just to make sure
+	{7.5f, END, T::ARM_MOVE_TO_BOTTOM, 0, 0, T::ALWAYS},
+	{0.0f, 0.1f, T::WINCH_WIND_BACK, 0, 0, T::ALWAYS},
+	{2.5f, 6.0f, T::WINCH_FIRE, 0, 0, T::WHEN_ARM_CAN_FIRE},
+	{7.5f, END, T::WINCH_FIRE, 0, 0, T::WHEN_ARM_CAN_FIRE}
+};
+
+static const T::step DRIVE_FORWARD_STEPS[] = {
+	{0.0f, END, T::ARCADE_DRIVE, 0.5f, 0.0f, T::ALWAYS},
+	//flash red twice, then hold green
+	{0.0f, 0.5f, T::LED_COLOR, DigitalLED::RED, 0, T::ALWAYS},
+	{0.5f, 1.0f, T::LED_COLOR, DigitalLED::OFF, 0, T::ALWAYS},
+	{1.0f, 1.5f, T::LED_COLOR, DigitalLED::RED, 0, T::ALWAYS},
+	{1.5f, 2.0f, T::LED_COLOR, DigitalLED::OFF, 0, T::ALWAYS},
+	{2.0f, END, T::LED_COLOR, DigitalLED::GREEN, 0, T::ALWAYS}
+};
+
+#define STEPS(s) s, sizeof(s) / sizeof(s[0])
+//copilot button n in disabled picks routine n - 1
+static const T::routine ROUTINES[] = {
+	{"auton two ball", STEPS(TWO_BALL_STEPS), LoopProfiler::AUTON_TWO_BALL},
+	{"auton main", STEPS(MAIN_STEPS), LoopProfiler::AUTON_MAIN},
+	{"auton drive", STEPS(DRIVE_FORWARD_STEPS), LoopProfiler::AUTON_DRIVE_FORWARD}
+};
+#undef STEPS
+static const int NUM_ROUTINES = sizeof(ROUTINES) / sizeof(ROUTINES[0]);
 
-	winch = new Winch(winch_motor, clutch, winch_encoder, winch_max_switch);
+AerialAssistRobot::AerialAssistRobot(void)	{
 
-	ultrasonic = new Ultrasonic(RANGE_FINDER_PING_CHANNEL_DIO, RANGE_FINDER_ECHO_CHANNEL_DIO);
-	rangefinder = new Rangefinder(ultrasonic);
+}
+
+void AerialAssistRobot::RobotInit(void) {
+	init_started_us = GetFPGATime();
+	StaticArena * arena = &robot_arena;
+
+	//grouped by who touches them, busiest first; every cycle and every scheduler tick
+	arena->begin_group("frames");
+	//everything but the drive, the arm pivot and the winch motor is written through this
+	outputs = new (arena) OutputFrame();
+	//and everything but the interrupts and the arm's position loop reads through this
+	sensors = new (arena) SensorFrame();
+
+	//200 Hz
+	arena->begin_group("arm");
+	roller = new (arena) Victor(ROLLER_PWM);
+	arm_lift = new (arena) Victor(ARM_LIFT_PWM);
+	arm_floor = new (arena) DigitalInput(ARM_FLOOR_SWITCH_DIO);
+	arm_top = new (arena) DigitalInput(ARM_TOP_SWITCH_DIO);
+	arm_ball = new (arena) DigitalInput(ARM_LINE_BREAK_DIO);
+	arm_encoder = new (arena) Encoder(ARM_ENCODER_A_CHANNEL, ARM_ENCODER_B_CHANNEL, false);
+
+	arm = new (arena) Arm(roller, arm_lift, arm_encoder, arm_floor, arm_top, arm_ball, sensors, outputs, arena);
+	arm_floor_input = sensors->add(arm_floor);
+	arm_top_input = sensors->add(arm_top);
+	arm_ball_input = sensors->add(arm_ball);
+	arm_encoder_input = sensors->add(arm_encoder);
+
+	//100 Hz
+	arena->begin_group("winch");
+	winch_motor = new (arena) Victor(WINCH_PWM);
+	winch_encoder = new (arena) Encoder(WINCH_ENCODER_A_CHANNEL, WINCH_ENCODER_B_CHANNEL);
+	winch_max_switch = new (arena) DigitalInput (WINCH_MAX_LIMIT_DIO);
+	clutch = new (arena) Solenoid(CLUTCH_SOL);
+
+	winch = new (arena) Winch(winch_motor, clutch, winch_encoder, winch_max_switch, sensors, outputs, arena);
+	winch_encoder_input = sensors->add(winch_encoder);
+	winch_max_input = sensors->add(winch_max_switch);
+
+	//the periodic functions, 50 Hz
+	arena->begin_group("drive");
+	front_left = new (arena) Talon(FRONT_LEFT_DRIVE_PWM);
+	front_right = new (arena) Talon(FRONT_RIGHT_DRIVE_PWM);
+	rear_left = new (arena) Talon(REAR_LEFT_DRIVE_PWM);
+	rear_right = new (arena) Talon(REAR_RIGHT_DRIVE_PWM);
+	drive = new (arena) RobotDrive(front_left, rear_left, front_right, rear_right);
+	drive_shaper = new (arena) DriveShaper(arena);
+	drive->SetInvertedMotor(RobotDrive::kFrontLeftMotor, false);
+	drive->SetInvertedMotor(RobotDrive::kRearLeftMotor, false);
+	drive->SetInvertedMotor(RobotDrive::kFrontRightMotor, false);
+	drive->SetInvertedMotor(RobotDrive::kRearRightMotor, false);
 
+	gear_shift = new (arena) DoubleSolenoid(GEAR_SHIFT_SOL_FORWARD, GEAR_SHIFT_SOL_REVERSE);
+	gear_shift_output = outputs->add(gear_shift);
+
+	pilot = new (arena) Gamepad(1);
+	copilot = new (arena) Gamepad(2);
+	pilot->SetSnapshotMode(true);
+	copilot->SetSnapshotMode(true);
+	timer = new (arena) Timer();
+
+	arena->begin_group("led");
+	led_red_channel = new (arena) DigitalOutput(RED_LED_DIO);
+	led_green_channel = new (arena) DigitalOutput(GREEN_LED_DIO);
+	led_blue_channel = new (arena) DigitalOutput(BLUE_LED_DIO);
+	led = new (arena) DigitalLED(led_red_channel, led_green_channel, led_blue_channel, outputs);
+
+	//about 33 Hz
+	arena->begin_group("ranging");
+	ultrasonic_ping = new (arena) DigitalOutput(RANGE_FINDER_PING_CHANNEL_DIO);
+	ultrasonic_echo = new (arena) DigitalInput(RANGE_FINDER_ECHO_CHANNEL_DIO);
+	ultrasonic = new (arena) Ultrasonic(ultrasonic_ping, ultrasonic_echo);
+	ranging = new (arena) RangingScheduler(RangingScheduler::DEFAULT_PING_PERIOD, arena);
+	rangefinder = new (arena) Rangefinder(ranging, ranging->add_sensor(ultrasonic, ultrasonic_echo));
+	ranging->start();
+	range_input = sensors->add(rangefinder);
+
+	//the rest is bookkeeping, the driver station and the big tables
+	arena->begin_group("scheduling");
+	scheduler = new (arena) RateScheduler(RateScheduler::DEFAULT_BASE_RATE, arena);
+	profiler = new (arena) LoopProfiler();
+	profiler->set_budget(LOOP_BUDGET);
+
+	arena->begin_group("diagnostics");
 	//pressure_switch = new DigitalInput(PRESSURE_SWITCH_DIO);
-	compressor = new Compressor(PRESSURE_SWITCH_DIO, COMPRESSOR_RELAY);
+	compressor = new (arena) Compressor(PRESSURE_SWITCH_DIO, COMPRESSOR_RELAY);
 	lcd = DriverStationLCD::GetInstance();
+	display = new (arena) DiagnosticsDisplay(lcd, DiagnosticsDisplay::DEFAULT_UPDATE_RATE, arena);
 	ds = DriverStation::GetInstance();
 	if (ds->GetAlliance() == DriverStation::kBlue){
 		alliance_color = DigitalLED::BLUE;
@@ -55,193 +199,218 @@ void AerialAssistRobot::RobotInit(void) {
 
 	//camera = &AxisCamera::GetInstance();
 
-	timer = new Timer();
-
-	pilot = new Gamepad(1);
-	copilot = new Gamepad(2);
+	recorder = new (arena) TelemetryRecorder(TELEMETRY_LOG, TELEMETRY_INDEX, arena);
+	recorder->start();
 
+	arena->begin_group("auton");
+	timeline = new (arena) AutonTimeline(drive, arm, winch, led);
+	for (int i = 0; i < NUM_ROUTINES; i++){
+		if (timeline->load(ROUTINES[i]) > 0){
+			printf("auton %s has problems, see above\n", ROUTINES[i].name);
+		}
+	}
+	select_auton_routine(0);
+
+	//each mode's Init picks which of these run
+	arm_task = scheduler->add("arm", update_arm, arm, ARM_RATE, 0);
+	winch_task = scheduler->add("winch", update_winch, winch, WINCH_RATE, 1);
+	winch_safety_task = scheduler->add("winch safe", update_winch_safety, winch, WINCH_RATE, 1);
+	ranging_task = scheduler->add("ranging", update_rangefinder, rangefinder,
+			1.0 / RangingScheduler::DEFAULT_PING_PERIOD, 2);
+	diagnostics_task = scheduler->add("diagnostics", update_display, display, DIAGNOSTICS_RATE, 3);
+	scheduler->set_tick_begin(latch_sensors, sensors);
+	scheduler->set_tick_end(commit_outputs, outputs);
+	scheduler->start();
+
+	init_done_us = GetFPGATime();
+	enabled_yet = false;
+	printf("robot init: started %.3f s after boot, took %.1f ms\n", init_started_us * 1.0e-6,
+			(init_done_us - init_started_us) * 1.0e-3);
+	arena->report();
 }
 
 void AerialAssistRobot::DisabledInit(void) {
-	lcd->Clear();
+	profiler->dump(); //whatever ran since the last time we were disabled
+	scheduler->dump();
+	recorder->request_flush();
+	printf("telemetry: %u records written (%u bytes), %u dropped\n", recorder->get_written(),
+			recorder->get_bytes_written(), recorder->get_dropped());
+	ArmCalibration * calibration = arm->get_calibration();
+	printf("arm encoder: %u re-zeros, last drift %d, worst %d, top to floor %d ticks\n",
+			calibration->get_rezeros(), calibration->get_last_drift(), calibration->get_worst_drift(),
+			calibration->get_measured_span());
+	scheduler->lock();
+	scheduler->set_active(diagnostics_task);
+	profiler->set_mode(LoopProfiler::DISABLED);
+	display->clear();
+	scheduler->unlock();
 }
 
-void AerialAssistRobot::AutonomousMainInit(void) {
-	gear_shift->Set(HIGH_GEAR);
-	winch->wind_back();
-	timer->Reset();
-	timer->Start();
-	compressor->Start(); //required by rules
+/*
+ * One cycle's worth of inputs and outputs, for the telemetry file
+ * Fill it under the scheduler lock, then add it to the recorder after unlocking: the
+ * compression is the slow part, and it only touches the recorder.
+ * switches: bit 0 arm floor, 1 arm top, 2 ball line break, 3 winch max, 4 pressure switch (raw values)
+ * outputs: front left, front right, rear left, rear right, roller, arm lift, winch
+ * solenoids: bit 0 clutch, bits 1-2 gear shift
+ */
+void AerialAssistRobot::fill_telemetry(TelemetryRecorder::record &r) {
+	r.timestamp = GetFPGATime();
+	r.arm_encoder = sensors->get_count(arm_encoder_input);
+	r.winch_encoder = sensors->get_count(winch_encoder_input);
+	r.range = sensors->get_range(range_input);
+
+	const Gamepad::InputFrame &p = pilot->GetFrame();
+	const Gamepad::InputFrame &c = copilot->GetFrame();
+	r.pilot_buttons = p.buttons;
+	r.copilot_buttons = c.buttons;
+	for (int i = 0; i < 4; i++){
+		r.pilot_axes[i] = TelemetryRecorder::pack_output(p.axes[i + 1]);
+		r.copilot_axes[i] = TelemetryRecorder::pack_output(c.axes[i + 1]);
+	}
+
+	r.switches = sensors->get(arm_floor_input) | sensors->get(arm_top_input) << 1
+			| sensors->get(arm_ball_input) << 2 | sensors->get(winch_max_input) << 3
+			| compressor->GetPressureSwitchValue() << 4;
+
+	r.outputs[0] = TelemetryRecorder::pack_output(front_left->Get());
+	r.outputs[1] = TelemetryRecorder::pack_output(front_right->Get());
+	r.outputs[2] = TelemetryRecorder::pack_output(rear_left->Get());
+	r.outputs[3] = TelemetryRecorder::pack_output(rear_right->Get());
+	r.outputs[4] = TelemetryRecorder::pack_output(roller->Get());
+	r.outputs[5] = TelemetryRecorder::pack_output(arm_lift->Get());
+	r.outputs[6] = TelemetryRecorder::pack_output(winch_motor->Get());
+	r.solenoids = clutch->Get() | gear_shift->Get() << 1;
+	r.led = led->Get();
+	r.mode = profiler->get_mode();
 }
 
-void AerialAssistRobot::AutonomousDriveForwardInit(void) {
-	gear_shift->Set(HIGH_GEAR);
-	timer->Reset();
-	timer->Start();
-	compressor->Start(); //required by rules
+//the first time the robot is enabled, prints how long it took to get there
+void AerialAssistRobot::note_enabled() {
+	if (enabled_yet){
+		return;
+	}
+	enabled_yet = true;
+	UINT32 now = GetFPGATime();
+	printf("first enabled: %.3f s after boot, %.3f s after robot init\n", now * 1.0e-6,
+			(now - init_done_us) * 1.0e-6);
+}
+
+void AerialAssistRobot::select_auton_routine(int n) {
+	auton_routine = n;
+	timeline->load(ROUTINES[n]);
 }
 
-void AerialAssistRobot::AutonomousTwoBallInit(void) {
-	gear_shift->Set(HIGH_GEAR);
-	winch->wind_back();
+void AerialAssistRobot::AutonomousInit(void) {
+	note_enabled();
+	scheduler->lock();
+	scheduler->set_active(arm_task | winch_task | ranging_task | diagnostics_task);
+	profiler->set_mode(timeline->get_routine()->profiler_mode);
+	outputs->set(gear_shift_output, HIGH_GEAR);
+	timeline->start();
 	timer->Reset();
 	timer->Start();
 	compressor->Start(); //required by rules
+	scheduler->unlock();
 }
 
 void AerialAssistRobot::TeleopInit(void) {
+	note_enabled();
+	scheduler->lock();
+	scheduler->set_active(arm_task | winch_task | ranging_task | diagnostics_task);
+	profiler->set_mode(LoopProfiler::TELEOP);
+	drive_shaper->reset();
 	compressor->Start();
 	firing = false;
+	scheduler->unlock();
 }
 
 void AerialAssistRobot::DisabledPeriodic(void)  {
-	lcd->PrintfLine(DriverStationLCD::kUser_Line1, "disabled");
-	led->Set(alliance_color);
-	lcd->UpdateLCD();
-}
-
-void AerialAssistRobot::AutonomousMainPeriodic(void) {
-	double time_s = timer->Get();
-	if (time_s < 2.5){
-		arm->drop_ball_in();
-	} else if (time_s < 4.5){
-		arm->move_to_bottom();
-	}
-
-	if (time_s > 7.0 && time_s < 7.5){
-		winch->fire();
-		lcd->PrintfLine(DriverStationLCD::kUser_Line4, "firing");
-	} else {
-		lcd->PrintfLine(DriverStationLCD::kUser_Line4, "");
-	}
-	if (time_s < 6.0){
-		drive->ArcadeDrive(0.5f, -0.2f); //TODO: May need to compensate for drive-train turn
-		lcd->PrintfLine(DriverStationLCD::kUser_Line5, "left: %f", front_left->Get());
-		lcd->PrintfLine(DriverStationLCD::kUser_Line6, "right: %f", front_right->Get());
-	}
-
-	//flash LEDs
-	//flash red from (0.0 -> 0.5) and (1.0 -> 1.5), then hold green from 2.0s on
-	if(time_s > 5.0 && time_s < 5.5 || time_s > 6.0 && time_s < 6.5){
-		led->Set(DigitalLED::RED);
-	} else if (time_s > 5.5 && time_s < 6.0 || time_s > 6.5 && time_s < 7.0){
-		led->Set(DigitalLED::OFF);
-	} else if (time_s > 7.0){
-		led->Set(DigitalLED::GREEN);
-	}
-
-	arm->update();
-	winch->update();
-	rangefinder->update();
-	lcd->PrintfLine(DriverStationLCD::kUser_Line1, "auton");
-	lcd->PrintfLine(DriverStationLCD::kUser_Line2, "time: %f", time_s);
-	lcd->PrintfLine(DriverStationLCD::kUser_Line3, "dist: %f", rangefinder->Get());
-	lcd->UpdateLCD();
-}
-
-//TWO-BALL AUTON:
-void AerialAssistRobot::AutonomousTwoBallPeriodic(void) {
-	double time_s = timer->Get();
-	if(time_s < 2.5){
-		arm->drop_ball_in();
-		drive->ArcadeDrive(-0.4f,0.0f);
-	}
-	
-	if (time_s > 2.5 && time_s < 6.0){
-		arm->load_sequence();
-		if (arm->can_fire()){
-			winch->fire();
-		}
-	}
-	
-	if (time_s > 6.0 && time_s < 7.5){
-		arm->drop_ball_in(); //just to make sure
-	}
-	
-	if (time_s > 7.5){
-		arm->move_to_bottom();
-		if (arm->can_fire()){
-			winch->fire();
+	profiler->start(LoopProfiler::LOOP);
+	scheduler->lock();
+	sensors->latch();
+	copilot->Latch();
+	for (int i = 0; i < NUM_ROUTINES; i++){
+		if (copilot->GetNumberedButtonPressed(i + 1)){
+			select_auton_routine(i);
 		}
 	}
-	
-	if (time_s > 4.0){
-		drive->ArcadeDrive(0.5, 0.0);
-	}
-	
-	
-	arm->update();
-	winch->update();
-	rangefinder->update();
-	lcd->PrintfLine(DriverStationLCD::kUser_Line1, "auton");
-	lcd->PrintfLine(DriverStationLCD::kUser_Line2, "time: %f", time_s);
-	lcd->PrintfLine(DriverStationLCD::kUser_Line3, "dist: %f", rangefinder->Get());
-	lcd->UpdateLCD();
+	display->print(DriverStationLCD::kUser_Line1, "disabled");
+	display->print(DriverStationLCD::kUser_Line2, ROUTINES[auton_routine].name);
+	//overruns so far and what the last one was blamed on
+	display->print_int(DriverStationLCD::kUser_Line3, "overruns: %d", profiler->get_overruns());
+	display->print(DriverStationLCD::kUser_Line4, profiler->get_overruns() > 0 ?
+			LoopProfiler::stage_name(profiler->get_last_overrun_stage()) : "");
+	display->print_int(DriverStationLCD::kUser_Line5, "arm drift: %d", arm->get_calibration()->get_worst_drift());
+	led->Set(alliance_color);
+	outputs->commit();
+	TelemetryRecorder::record r;
+	fill_telemetry(r);
+	scheduler->unlock();
+	profiler->start(LoopProfiler::TELEMETRY);
+	recorder->add(r);
+	profiler->stop(LoopProfiler::TELEMETRY);
+	profiler->stop(LoopProfiler::LOOP);
 }
-void AerialAssistRobot::AutonomousDriveForwardPeriodic() {
+
+void AerialAssistRobot::AutonomousPeriodic(void) {
+	profiler->start(LoopProfiler::LOOP);
+	scheduler->lock();
+	sensors->latch();
 	double time_s = timer->Get();
-	
-	drive->ArcadeDrive(0.5f, 0.0f);
-	//drive->ArcadeDrive(0.5f, -0.4f);
-	lcd->PrintfLine(DriverStationLCD::kUser_Line5, "left: %f", front_left->Get());
-	lcd->PrintfLine(DriverStationLCD::kUser_Line6, "right: %f", front_right->Get());
-	
-	//flash LEDs
-	//flash red from (0.0 -> 0.5) and (1.0 -> 1.5), then hold green from 2.0s on
-	if(time_s < 0.5 || time_s > 1.0 && time_s < 1.5){
-		led->Set(DigitalLED::RED);
-	} else if (time_s > 0.5 && time_s < 1.0 || time_s > 1.5 && time_s < 2.0){
-		led->Set(DigitalLED::OFF);
-	} else {
-		led->Set(DigitalLED::GREEN);
-	}
-	
-	rangefinder->update();
-	arm->update();
-	winch->update();
-	lcd->PrintfLine(DriverStationLCD::kUser_Line1, "auton drive");
-	lcd->PrintfLine(DriverStationLCD::kUser_Line2, "time: %f", timer->Get());
-	lcd->PrintfLine(DriverStationLCD::kUser_Line3, "dist: %f", rangefinder->Get());
-	lcd->UpdateLCD();
+	profiler->start(LoopProfiler::COMMANDS);
+	arm->begin_cycle();
+	timeline->update(time_s);
+	profiler->stop(LoopProfiler::COMMANDS);
+
+	profiler->start(LoopProfiler::LCD);
+	display->print(DriverStationLCD::kUser_Line1, timeline->get_routine()->name);
+	display->print_float(DriverStationLCD::kUser_Line2, "time: %f", time_s);
+	display->print_float(DriverStationLCD::kUser_Line3, "dist: %f", sensors->get_range(range_input));
+	display->print_int(DriverStationLCD::kUser_Line4, "overruns: %d", profiler->get_overruns());
+	display->print_float(DriverStationLCD::kUser_Line5, "left: %f", front_left->Get());
+	display->print_float(DriverStationLCD::kUser_Line6, "right: %f", front_right->Get());
+	profiler->stop(LoopProfiler::LCD);
+	outputs->commit();
+	TelemetryRecorder::record r;
+	fill_telemetry(r);
+	scheduler->unlock();
+	profiler->start(LoopProfiler::TELEMETRY);
+	recorder->add(r);
+	profiler->stop(LoopProfiler::TELEMETRY);
+	profiler->stop(LoopProfiler::LOOP);
 }
 
 void AerialAssistRobot::TeleopPeriodic(void) {
+	profiler->start(LoopProfiler::LOOP);
+	scheduler->lock();
+	profiler->start(LoopProfiler::INPUT);
+	sensors->latch();
+	pilot->Latch();
+	copilot->Latch();
+	profiler->stop(LoopProfiler::INPUT);
+	profiler->start(LoopProfiler::DRIVE);
 	//standard arcade drive using left and right sticks
-	//clamp the values so small inputs are ignored
-	float speed = -pilot->GetLeftY();
-	speed = clamp(speed, 0.05f);
-	float turn = -pilot->GetRightX();
-	turn = clamp(turn, 0.05f);
-
-	//lcd->PrintfLine(DriverStationLCD::kUser_Line2, "%f %f", speed, turn);
-
-	max_delta_speed = 1.0f / (MAX_ACCEL_TIME * GetLoopsPerSec()); //1.0 represents the maximum victor input
-	//float delta_turn = turn - old_turn;
-	float delta_speed = speed - old_speed;
-
-	if (delta_speed > max_delta_speed){
-		speed = old_speed + max_delta_speed;
-	} else if (delta_speed < -max_delta_speed){
-		speed = old_speed - max_delta_speed;
-	}
-	//if neither of these is the case, |delta_speed| is less than the max 
-	//and we can just use the given value without modification.
+	//shaped so small inputs are ignored and acceleration is limited
+	float speed, turn;
+	drive_shaper->update(-pilot->GetLeftY(), -pilot->GetRightX(), speed, turn);
 
-	lcd->PrintfLine(DriverStationLCD::kUser_Line2, "%f %f", speed, turn);
+	display->print_floats(DriverStationLCD::kUser_Line2, "%f %f", speed, turn);
 	//lcd->PrintfLine(DriverStationLCD::kUser_Line3, "%f %f", left_drive->Get(), right_drive->Get());
 
-	drive->ArcadeDrive(speed, turn);
+	drive->ArcadeDrive(speed, turn, false); //already shaped
 	//drive->TankDrive(-pilot->GetLeftY(), pilot->GetRightY());
-	old_turn = turn;
-	old_speed = speed;
 
 	if (pilot->GetNumberedButton(5) || pilot->GetNumberedButton(6) 
 			|| pilot->GetNumberedButton(7) || pilot->GetNumberedButton(8)) {
-		gear_shift->Set(LOW_GEAR);
+		outputs->set(gear_shift_output, LOW_GEAR);
 	} else {
-		gear_shift->Set(HIGH_GEAR);
+		outputs->set(gear_shift_output, HIGH_GEAR);
 	}
+	profiler->stop(LoopProfiler::DRIVE);
 
+	profiler->start(LoopProfiler::COMMANDS);
+	arm->begin_cycle();
 	if (copilot->GetNumberedButton(Gamepad::F310_X)){
 		arm->load_sequence();
 	} else if (copilot->GetNumberedButtonReleased(Gamepad::F310_X)){
@@ -277,7 +446,7 @@ void AerialAssistRobot::TeleopPeriodic(void) {
 		arm->move_towards_low_goal();
 	}
 	
-	lcd->PrintfLine(DriverStationLCD::kUser_Line5, "winch: %d", winch_max_switch->Get());
+	display->print_int(DriverStationLCD::kUser_Line5, "winch: %d", sensors->get(winch_max_input));
 	
 	if (copilot->GetNumberedButtonPressed(Gamepad::F310_B)){
 		firing = true;
@@ -297,6 +466,11 @@ void AerialAssistRobot::TeleopPeriodic(void) {
 	if (copilot->GetNumberedButton(8)){
 		winch->wind_back();
 	}
+	
+	//wind back just far enough for a shot from where the rangefinder says we are
+	if (copilot->GetNumberedButton(Gamepad::F310_BACK)){
+		winch->wind_back_dist(sensors->get_range(range_input) / 12.0f);
+	}
 
 	if (!winch->wound_back()){
 		led->Set(DigitalLED::YELLOW);
@@ -305,17 +479,15 @@ void AerialAssistRobot::TeleopPeriodic(void) {
 	} else {
 		led->Set(alliance_color);
 	}
+	profiler->stop(LoopProfiler::COMMANDS);
 
 	//camera->GetImage();
 
-	arm->update();
-	winch->update();
-	rangefinder->update();
-	
-	lcd->PrintfLine(DriverStationLCD::kUser_Line1, "teleop");
-	lcd->PrintfLine(DriverStationLCD::kUser_Line3, "enc: %d", arm_encoder->Get());
-	lcd->PrintfLine(DriverStationLCD::kUser_Line4, "arm: %d", arm_top->Get());
-	lcd->PrintfLine(DriverStationLCD::kUser_Line6, "wv: %f", winch_motor->Get());
+	profiler->start(LoopProfiler::LCD);
+	display->print_int(DriverStationLCD::kUser_Line1, "teleop  overruns: %d", profiler->get_overruns());
+	display->print_int(DriverStationLCD::kUser_Line3, "enc: %d", arm->get_position());
+	display->print_int(DriverStationLCD::kUser_Line4, "arm: %d", sensors->get(arm_top_input));
+	display->print_float(DriverStationLCD::kUser_Line6, "wv: %f", winch_motor->Get());
 	/*
 	if (arm->ball_captured()){
 		lcd->PrintfLine(DriverStationLCD::kUser_Line6, "lb broken");
@@ -324,7 +496,15 @@ void AerialAssistRobot::TeleopPeriodic(void) {
 	}
 	*/
 	//lcd->PrintfLine(DriverStationLCD::kUser_Line6, "distance: %f", rangefinder->Get());
-	lcd->UpdateLCD();	
+	profiler->stop(LoopProfiler::LCD);
+	outputs->commit();
+	TelemetryRecorder::record r;
+	fill_telemetry(r);
+	scheduler->unlock();
+	profiler->start(LoopProfiler::TELEMETRY);
+	recorder->add(r);
+	profiler->stop(LoopProfiler::TELEMETRY);
+	profiler->stop(LoopProfiler::LOOP);
 }
 
 void AerialAssistRobot::TestInit() {
@@ -335,13 +515,20 @@ void AerialAssistRobot::TestPeriodic(){
 }
 
 void AerialAssistRobot::ColorTestInit() {
-	lcd->Clear();
+	scheduler->lock();
+	scheduler->set_active(diagnostics_task);
+	profiler->set_mode(LoopProfiler::COLOR_TEST);
+	display->clear();
 	red = false;
 	green = false;
 	blue = false;
+	scheduler->unlock();
 }
 
 void AerialAssistRobot::ColorTestPeriodic() {
+	scheduler->lock();
+	sensors->latch();
+	copilot->Latch();
 	if (copilot->GetNumberedButtonPressed(Gamepad::F310_B)){
 		red = !red;
 	}
@@ -355,53 +542,57 @@ void AerialAssistRobot::ColorTestPeriodic() {
 
 	drive->ArcadeDrive(0.0f, 0.0f);
 	
-	lcd->PrintfLine(DriverStationLCD::kUser_Line1, "test");
-	lcd->PrintfLine(DriverStationLCD::kUser_Line2, "r: %d", red);
-	lcd->PrintfLine(DriverStationLCD::kUser_Line3, "g: %d", green);
-	lcd->PrintfLine(DriverStationLCD::kUser_Line4, "b: %d", blue);
-	lcd->UpdateLCD();
-
+	display->print(DriverStationLCD::kUser_Line1, "test");
+	display->print_int(DriverStationLCD::kUser_Line2, "r: %d", red);
+	display->print_int(DriverStationLCD::kUser_Line3, "g: %d", green);
+	display->print_int(DriverStationLCD::kUser_Line4, "b: %d", blue);
+	outputs->commit();
+	TelemetryRecorder::record r;
+	fill_telemetry(r);
+	scheduler->unlock();
+	recorder->add(r);
 }
 
 void AerialAssistRobot::SafetyTestInit(){
-	lcd->Clear();
+	note_enabled();
+	scheduler->lock();
+	scheduler->set_active(arm_task | winch_safety_task | ranging_task | diagnostics_task);
+	profiler->set_mode(LoopProfiler::SAFETY_TEST);
+	drive_shaper->reset();
+	display->clear();
 	compressor->Start();
 	firing = false;	
-	gear_shift->Set(HIGH_GEAR);
+	outputs->set(gear_shift_output, HIGH_GEAR);
+	scheduler->unlock();
 }
 
 void AerialAssistRobot::SafetyTestPeriodic(){
+	profiler->start(LoopProfiler::LOOP);
+	scheduler->lock();
+	profiler->start(LoopProfiler::INPUT);
+	sensors->latch();
+	pilot->Latch();
+	copilot->Latch();
+	profiler->stop(LoopProfiler::INPUT);
+	profiler->start(LoopProfiler::DRIVE);
 	/*
 	 * HEY YALL!
 	 * THIS IS SAFETY MODE
 	 */
 	
 	//standard arcade drive using left and right sticks
-	//clamp the values so small inputs are ignored
+	//shaped so small inputs are ignored and acceleration is limited
 	//also limit the speed to 25% power cuz this safety mode!
-	float speed = 0.5*(-pilot->GetLeftY());
-	speed = clamp(speed, 0.05f);
-	float turn = 0.6*(-pilot->GetRightX());
-	turn = clamp(turn, 0.05f);
-
-	max_delta_speed = 1.0f / (MAX_ACCEL_TIME * GetLoopsPerSec()); //1.0 represents the maximum victor input
-
-	float delta_speed = speed - old_speed;
+	float speed, turn;
+	drive_shaper->update(-pilot->GetLeftY(), -pilot->GetRightX(), speed, turn, 0.25f, 0.36f);
 
-	if (delta_speed > max_delta_speed){
-		speed = old_speed + max_delta_speed;
-	} else if (delta_speed < -max_delta_speed){
-		speed = old_speed - max_delta_speed;
-	}
-
-	lcd->PrintfLine(DriverStationLCD::kUser_Line2, "%f %f", speed, turn);
-
-	drive->ArcadeDrive(speed, turn);
-
-	old_turn = turn;
-	old_speed = speed;
+	display->print_floats(DriverStationLCD::kUser_Line2, "%f %f", speed, turn);
 
+	drive->ArcadeDrive(speed, turn, false); //already shaped
+	profiler->stop(LoopProfiler::DRIVE);
 
+	profiler->start(LoopProfiler::COMMANDS);
+	arm->begin_cycle();
 	if (copilot->GetNumberedButton(Gamepad::F310_X)){
 		arm->load_sequence();
 	} else if (copilot->GetNumberedButtonReleased(Gamepad::F310_X)){
@@ -437,7 +628,7 @@ void AerialAssistRobot::SafetyTestPeriodic(){
 		arm->move_towards_low_goal();
 	}
 	
-	lcd->PrintfLine(DriverStationLCD::kUser_Line5, "winch: %d", winch_max_switch->Get());
+	display->print_int(DriverStationLCD::kUser_Line5, "winch: %d", sensors->get(winch_max_input));
 	
 	if (copilot->GetNumberedButtonPressed(Gamepad::F310_B)){
 		firing = true;
@@ -465,17 +656,15 @@ void AerialAssistRobot::SafetyTestPeriodic(){
 	} else {
 		led->Set(alliance_color);
 	}
+	profiler->stop(LoopProfiler::COMMANDS);
 
 	//camera->GetImage();
 
-	arm->update();
-	winch->update(true);
-	rangefinder->update();
-	
-	lcd->PrintfLine(DriverStationLCD::kUser_Line1, "Safety Mode!!!!");
-	lcd->PrintfLine(DriverStationLCD::kUser_Line3, "enc: %d", arm_encoder->Get());
-	lcd->PrintfLine(DriverStationLCD::kUser_Line4, "arm: %d", arm_top->Get());
-	lcd->PrintfLine(DriverStationLCD::kUser_Line6, "wv: %f", winch_motor->Get());
+	profiler->start(LoopProfiler::LCD);
+	display->print(DriverStationLCD::kUser_Line1, "Safety Mode!!!!");
+	display->print_int(DriverStationLCD::kUser_Line3, "enc: %d", arm->get_position());
+	display->print_int(DriverStationLCD::kUser_Line4, "arm: %d", sensors->get(arm_top_input));
+	display->print_float(DriverStationLCD::kUser_Line6, "wv: %f", winch_motor->Get());
 	/*
 	if (arm->ball_captured()){
 		lcd->PrintfLine(DriverStationLCD::kUser_Line6, "lb broken");
@@ -484,5 +673,13 @@ void AerialAssistRobot::SafetyTestPeriodic(){
 	}
 	*/
 	//lcd->PrintfLine(DriverStationLCD::kUser_Line6, "distance: %f", rangefinder->Get());
-	lcd->UpdateLCD();
+	profiler->stop(LoopProfiler::LCD);
+	outputs->commit();
+	TelemetryRecorder::record r;
+	fill_telemetry(r);
+	scheduler->unlock();
+	profiler->start(LoopProfiler::TELEMETRY);
+	recorder->add(r);
+	profiler->stop(LoopProfiler::TELEMETRY);
+	profiler->stop(LoopProfiler::LOOP);
 }
@@ -6,6 +6,13 @@
 #include "Arm.h"
 #include "Rangefinder.h"
 #include "DigitalLED.h"
+#include "LoopProfiler.h"
+#include "DiagnosticsDisplay.h"
+#include "DriveShaper.h"
+#include "AutonTimeline.h"
+#include "TelemetryRecorder.h"
+#include "RateScheduler.h"
+#include "StaticArena.h"
 #include <cmath>
 
 class AerialAssistRobot : public IterativeRobot
@@ -26,7 +33,7 @@ private:
 	static const int PRESSURE_SWITCH_DIO = 6;
 	static const int WINCH_MAX_LIMIT_DIO = 4;
 	
-	static const int ARM_FLOOR_SWITCH_DIO = 5; //not used
+	static const int ARM_FLOOR_SWITCH_DIO = 5;
 	static const int ARM_TOP_SWITCH_DIO = 7;
 	static const int ARM_LINE_BREAK_DIO = 9;
  	
@@ -40,8 +47,8 @@ private:
     static const int GREEN_LED_DIO = 10;
     static const int BLUE_LED_DIO = 12;
     
-	static const int WINCH_ENCODER_A_CHANNEL = 5; //not used
-	static const int WINCH_ENCODER_B_CHANNEL = 8; //not used
+	static const int WINCH_ENCODER_A_CHANNEL = 5;
+	static const int WINCH_ENCODER_B_CHANNEL = 8;
 	
 	//Solenoids
 	static const int GEAR_SHIFT_SOL_FORWARD = 8;
@@ -52,20 +59,24 @@ private:
 	static const bool CLUTCH_IN = true;
 	static const bool CLUTCH_OUT = false;
 	
-    static const float MAX_ACCEL_TIME = 0.3f;        //how many seconds we want it to take to get to max speed
-    float max_delta_speed;
-    //max_delta_speed = 1.0 / (MAX_ACCEL_TIME * GetLoopsPerSec)
-    
     static const float FIRING_DISTANCE = 180.0f; //TODO: determine this for real
 	
+	//longest a periodic function may take before it counts as an overrun; the rest of
+	//the 20 ms packet period is left for the arm controller, telemetry and the DS task
+	static const double LOOP_BUDGET = 0.01;
+	
+	//subsystem update rates, Hz; ranging runs at the ping rate
+	static const double ARM_RATE = 200.0;
+	static const double WINCH_RATE = 100.0;
+	static const double DIAGNOSTICS_RATE = 25.0; //formats one LCD line per run, pushes at 5 Hz
 	
-    float old_turn, old_speed;
     
     Talon * front_left;
     Talon * front_right;
     Talon * rear_left;
     Talon * rear_right;
 	RobotDrive * drive;
+	DriveShaper * drive_shaper;
 	
 	DigitalInput * arm_floor;
 	DigitalInput * arm_top;
@@ -89,13 +100,28 @@ private:
 	DigitalLED * led;
 	DigitalLED::rgb_color alliance_color;
 	
+	OutputFrame * outputs;
+	SensorFrame * sensors;
+	//the robot's own reads from sensors; the subsystems keep theirs
+	int arm_floor_input;
+	int arm_top_input;
+	int arm_ball_input;
+	int arm_encoder_input;
+	int winch_encoder_input;
+	int winch_max_input;
+	int range_input;
+	
 	DoubleSolenoid * gear_shift;
+	int gear_shift_output;
 	Solenoid * clutch;
 	
 	//DigitalInput * pressure_switch;
 	Compressor * compressor;
 	
+	DigitalOutput * ultrasonic_ping;
+	DigitalInput * ultrasonic_echo;
 	Ultrasonic * ultrasonic;
+	RangingScheduler * ranging;
 	Rangefinder * rangefinder;
 	
 	Timer * timer;
@@ -106,23 +132,36 @@ private:
 	//AxisCamera * camera;
 	
 	DriverStationLCD * lcd;
+	DiagnosticsDisplay * display;
 	DriverStation * ds;
 	
+	LoopProfiler * profiler;
+	RateScheduler * scheduler;
+	RateScheduler::task_set arm_task;
+	RateScheduler::task_set winch_task;
+	RateScheduler::task_set winch_safety_task; //the winch with safety mode's short wind back
+	RateScheduler::task_set ranging_task;
+	RateScheduler::task_set diagnostics_task;
+	TelemetryRecorder * recorder;
+	void fill_telemetry(TelemetryRecorder::record &r);
+	
+	AutonTimeline * timeline;
+	int auton_routine; //index into the routine table in AerialAssistRobot.cpp
+	void select_auton_routine(int n);
+	
 	bool firing;
 	
+	//boot timing, FPGA microseconds
+	UINT32 init_started_us;
+	UINT32 init_done_us;
+	bool enabled_yet;
+	void note_enabled();
+	
 	bool red, green, blue; //for led testing control
-
-	inline float clamp(float input, float min){ return fabs(input) < fabs(min) ? 0.0f : input; }
 	
-	void AutonomousDriveForwardInit(void);
-	void AutonomousTwoBallInit(void);
-	void AutonomousMainInit(void);
 	void SafetyTestInit(void);
 	void ColorTestInit(void);
 	
-	void AutonomousMainPeriodic(void);
-	void AutonomousTwoBallPeriodic(void);
-	void AutonomousDriveForwardPeriodic(void);
 	void SafetyTestPeriodic(void);
 	void ColorTestPeriodic(void);
 	
@@ -131,12 +170,12 @@ public:
 	void RobotInit(void);
 	
 	void DisabledInit(void);
-	void AutonomousInit(void) { AutonomousTwoBallInit(); }
+	void AutonomousInit(void);
 	void TeleopInit(void);
 	void TestInit(void);
 	
 	void DisabledPeriodic(void);
-	void AutonomousPeriodic(void) { AutonomousTwoBallPeriodic(); }
+	void AutonomousPeriodic(void);
 	void TeleopPeriodic(void);
 	void TestPeriodic(void);
 };
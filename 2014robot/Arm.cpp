@@ -1,21 +1,44 @@
 #include "Arm.h"
 #include <cmath>
 
-Arm::Arm(Victor * roller_motor, Victor * pivot_motor, Encoder * enc, DigitalInput * floor, DigitalInput * top, DigitalInput * ball){
-	roller = roller_motor;
+Arm::Arm(Victor * roller_motor, Victor * pivot_motor, Encoder * enc, DigitalInput * floor, DigitalInput * top, DigitalInput * ball,
+		SensorFrame * sensor_frame, OutputFrame * frame, StaticArena * arena){
+	outputs = frame;
+	roller = outputs->add(roller_motor);
+	sensors = sensor_frame;
 	pivot = pivot_motor;
 	encoder = enc;
 	encoder->SetPIDSourceParameter(Encoder::kRate); //use the rate of rotation as the pid input
-	encoder->SetDistancePerPulse(90.0 / abs(TOP_POSITION - FLOOR_POSITION)); //correspond encoder ticks to degrees
+	encoder->SetDistancePerPulse(DEGREES_PER_TICK); //correspond encoder ticks to degrees
 	encoder->Start();
 	floor_switch = floor;
 	top_switch = top;
 	ball_switch = ball;
-	pid = new PIDController(0.1, 0.0, 0.0, encoder, pivot);
+	ball_input = sensors->add(ball_switch);
+	//the big profile tables first, so the small things the controller reads every tick end up together
+	const int named_positions[] = {TOP_POSITION, LOW_GOAL_POSITION, MINIMUM_FIRING_POSITION, FLOOR_POSITION};
+	profiles = new (arena) ArmProfile(named_positions, 4, TOP_POSITION, DEGREES_PER_TICK, ArmController::DEFAULT_PERIOD);
+	calibration = new (arena) ArmCalibration(encoder, TOP_POSITION, FLOOR_POSITION);
+	encoder_input = sensors->add(encoder, calibration); //so the frame latches the offset with the count
+	controller = new (arena) ArmController(pivot, calibration, DEGREES_PER_TICK, profiles,
+			ArmController::DEFAULT_PERIOD, arena);
+	timer = new (arena) Timer();
+	pid = new (arena) PIDController(0.1, 0.0, 0.0, encoder, pivot); //not used, so it goes last
+	//the switch stops the arm the moment it closes, rather than when update() next looks,
+	//and re-zeroes the encoder once per closing
+	top_switch->RequestInterrupts(Arm::top_switch_edge, this);
+	top_switch->SetUpSourceEdge(true, true);
+	top_switch->EnableInterrupts();
+	top_switch_edge(0, this); //whatever it is now
+	floor_switch->RequestInterrupts(Arm::floor_switch_closed, this);
+	floor_switch->SetUpSourceEdge(false, true);
+	floor_switch->EnableInterrupts();
+	controller->start();
 	pivot_set = false;
+	position_setpoint = TOP_POSITION;
+	profiled_mode = FREE;
 	arm_mode = FREE;
 	roller_mode = OFF;
-	timer = new Timer();
 }
 
 void Arm::run_roller_in() {
@@ -35,6 +58,7 @@ void Arm::drop_ball_in() {//override for run_roller_in function
 void Arm::load_sequence() {
 	switch (arm_mode) {
 		case FREE: 
+		case HOLDING_AT_BOTTOM: //update() may have parked it here between calls
 			arm_mode = LOWERING;
 		case LOWERING:
 			if (at_bottom() || ball_captured())
@@ -79,14 +103,14 @@ void Arm::move_up(){
 	if (!ball_captured()){
 		speed = -0.5;
 	}
-	pivot->Set(speed);
+	set_pivot(speed);
 
 	pivot_set = true;
 }
 
 void Arm::move_down(){
 	pid->Disable();
-	pivot->Set(0.5f);
+	set_pivot(0.5f);
 	if (ball_captured() && roller_mode == OFF){
 		roller_mode = DEPLOY; //move the roller to help prevent the ball from being pulled down
 	}
@@ -107,7 +131,7 @@ void Arm::move_down_curved(){
 }
 
 void Arm::move_up_interval(){
-	int pos = encoder->Get();
+	int pos = position();
 	float speed = 0.0f;
 	
 	if (ball_captured()){
@@ -125,22 +149,22 @@ void Arm::move_up_interval(){
 			speed = -0.1f;
 		}
 	}
-	pivot->Set(speed);
+	set_pivot(speed);
 }
 
 void Arm::move_down_interval(){
-	int pos = encoder->Get();
+	int pos = position();
 	float speed = 0.0f;
 	if (pos < 15) {
 		speed = 0.5f;
 	} else {
 		speed = 0.3f;
 	}
-	pivot->Set(speed);
+	set_pivot(speed);
 }
 
 void Arm::move_towards_low_goal(){
-	int pos = encoder->Get();
+	int pos = position();
 	if (pos > LOW_GOAL_POSITION){
 		move_up_curved();
 	} else if (pos < LOW_GOAL_POSITION - 10) {
@@ -165,10 +189,7 @@ void Arm::move_down_pid(){
 }
 
 void Arm::hold_position_pid(){
-	//pid->SetSetpoint(encoder->Get());
-	pid->SetSetpoint(0.0f);
-	pid->Enable();
-	pivot_set = true;
+	set_position(position());
 }
 
 void Arm::move_to_bottom() {
@@ -180,77 +201,131 @@ void Arm::move_to_top() {
 }
 
 bool Arm::ball_captured(){
-	return !ball_switch->Get();
+	return !sensors->get(ball_input);
 }
 
 bool Arm::at_top() {
-	return !top_switch->Get();
+	return controller->at_upper_limit();
+}
+
+void Arm::floor_switch_closed(UINT32 mask, void * arm) {
+	((Arm *)arm)->calibration->floor_reached();
+}
+
+void Arm::top_switch_edge(UINT32 mask, void * arm) {
+	Arm * self = (Arm *)arm;
+	if (!self->top_switch->Get()) {
+		self->controller->upper_limit_hit();
+		self->calibration->top_reached();
+	} else {
+		self->controller->upper_limit_released();
+	}
 }
 
 bool Arm::at_bottom() {
-	return encoder->Get() >= FLOOR_POSITION;
+	return position() >= FLOOR_POSITION;
 }
 
 bool Arm::can_fire() {
-	return encoder->Get() >= MINIMUM_FIRING_POSITION;
+	return position() >= MINIMUM_FIRING_POSITION;
 }
 
 void Arm::update(){
 	switch (roller_mode){
 		case OFF: 
-			roller->Set(0.0f); break;
+			outputs->set(roller, 0.0f); break;
 		case DEPLOY: 
-			roller->Set(0.3f); break;
+			outputs->set(roller, 0.3f); break;
 		case EJECT: 
-			roller->Set(-0.3f); break;
+			outputs->set(roller, -0.3f); break;
 		case INTAKE:
 			if (!ball_captured() || at_top())
-				roller->Set(0.3f);
+				outputs->set(roller, 0.3f);
 			else
-				roller->Set(0.0f);
+				outputs->set(roller, 0.0f);
 			break;
 	}
-	roller_mode = OFF; //roller must be reset continuously
 
 	switch (arm_mode) {
 		case FREE:
 			if (!pivot_set) {
-				pivot->Set(0.0f);
+				set_pivot(0.0f);
 				if (at_top())
 					arm_mode = HOLDING_AT_TOP;
 				if (at_bottom())
 					arm_mode = HOLDING_AT_BOTTOM;
 			}
-			pivot_set = false;
 			break;
 		case LOWERING:
 			if (at_bottom())
 				arm_mode = FREE;
+			else if (follow_profile_to(FLOOR_POSITION))
+				break;
 		case HOLDING_AT_BOTTOM:
 			if (!at_bottom())
 				move_down_curved();
 			else
-				pivot->Set(0.0f);
+				set_pivot(0.0f);
 			break;
 		case RAISING:
 			if (at_top())
 				arm_mode = FREE;
+			else if (follow_profile_to(TOP_POSITION))
+				break; //if the profile ends short of the switch, the curved move finishes it
 		case ROLLING_IN_BALL:	//hold at the top while we roll in the ball
 		case HOLDING_AT_TOP:
 			if (!at_top())
 				move_up_curved();
 			else
-				pivot->Set(0.0f);
+				set_pivot(0.0f);
+			break;
+		case POSITIONING:
+			controller->set_position(position_setpoint); //in case something moved it by hand
 			break;
 		default:
-			pivot->Set(0.0f);
+			set_pivot(0.0f);
+	}
+	if (arm_mode != LOWERING && arm_mode != RAISING){
+		profiled_mode = FREE;
 	}
-	if (at_top()){
-		encoder->Reset();
+}
+
+void Arm::begin_cycle(){
+	roller_mode = OFF; //roller must be reset continuously
+	pivot_set = false;
+}
+
+bool Arm::follow_profile_to(int target){
+	if (profiled_mode != arm_mode){
+		profiled_mode = arm_mode;
+		int profile = profiles->find(position(), target, PROFILE_START_TOLERANCE);
+		if (profile < 0){
+			return false; //not starting from anywhere we have a profile for
+		}
+		controller->follow_profile(profile, ball_captured());
 	}
+	return controller->following_profile();
 }
 
 
 void Arm::set_position(int pos){
-	//pid->SetSetpoint((pos * TOP_POSITION) / 100);
+	if (pos < TOP_POSITION){
+		pos = TOP_POSITION;
+	} else if (pos > FLOOR_POSITION){
+		pos = FLOOR_POSITION;
+	}
+	position_setpoint = pos;
+	arm_mode = POSITIONING;
+}
+
+bool Arm::at_position(){
+	return arm_mode == POSITIONING && abs(position() - position_setpoint) <= POSITION_TOLERANCE;
+}
+
+int Arm::position(){
+	return sensors->get_position(encoder_input);
+}
+
+void Arm::set_pivot(float speed){
+	controller->set_output(speed);
 }
@@ -2,6 +2,12 @@
 #define ARM_H_
 
 #include "WPILib.h"
+#include "ArmController.h"
+#include "ArmProfile.h"
+#include "ArmCalibration.h"
+#include "OutputFrame.h"
+#include "SensorFrame.h"
+#include "StaticArena.h"
 
 /*
  * This is the class that controls the arm (including the roller)
@@ -14,35 +20,73 @@
  * Unless of course they're part of the load sequence
  * When you move down while a ball is captured, and the roller is not being set to anything else,
  * It will spin to avoid moving the ball.
- * Also, call update() every cycle or nothing will work
+ * Also, call update() every cycle or nothing will work. It can run faster than the commands
+ * come in (the robot runs it at 200 Hz); call begin_cycle() before each cycle's commands
+ * and the one-cycle ones (roller, manual moves) last until the next begin_cycle()
  * This relies on the arm limit switch to calibrate the encoder and determine the top position
+ * (the floor switch, if it's wired, calibrates it too; see ArmCalibration)
+ * The pivot motor itself is driven by an ArmController running at 200 Hz; everything here
+ * just tells it what to do.
  */
 class Arm {
 private:
 	
-	Victor * roller;
+	OutputFrame * outputs;
+	int roller;
+	SensorFrame * sensors;
+	int encoder_input;
+	int ball_input;
 	Victor * pivot;
 	Encoder * encoder;
 	DigitalInput * floor_switch;
 	DigitalInput * top_switch;
 	DigitalInput * ball_switch;
 	PIDController * pid;
+	ArmController * controller;
+	ArmCalibration * calibration;
+	ArmProfile * profiles;
 	Timer * timer;
 	bool pivot_set;
 
 	typedef enum arm_mode_e 
 		{FREE, LOWERING, RAISING, WAITING_FOR_BALL, 
-		LOW_GOAL, HOLDING_AT_TOP, HOLDING_AT_BOTTOM, ROLLING_IN_BALL} arm_mode_t;
+		LOW_GOAL, HOLDING_AT_TOP, HOLDING_AT_BOTTOM, ROLLING_IN_BALL, POSITIONING} arm_mode_t;
 	arm_mode_t arm_mode;
 
 	typedef enum roller_mode_e {OFF, INTAKE, DEPLOY, EJECT} roller_mode_t;
 	roller_mode_t roller_mode;
+	
+	int position_setpoint;
+	static const int POSITION_TOLERANCE = 2; //ticks
+
+	//top switch interrupt, both edges: latches the top stop in the controller, and
+	//re-zeroes the encoder as it closes
+	static void top_switch_edge(UINT32 mask, void * arm);
+	//floor switch interrupt, closing edge: the second calibration point
+	static void floor_switch_closed(UINT32 mask, void * arm);
+	
+	//the mode a profiled move was last started for, so each move starts one once
+	arm_mode_t profiled_mode;
+	static const int PROFILE_START_TOLERANCE = 3; //ticks from a named position to use its profiles
+	/*
+	 * On entering a moving mode, starts the precomputed profile from the named position the
+	 * arm is at (if it's at one) to target. Returns true while that profile is running;
+	 * false means move the old way.
+	 */
+	bool follow_profile_to(int target);
+	
+	//this cycle's position, from the sensor frame
+	int position();
+
+	//open loop output for the pivot, passed on to the controller
+	void set_pivot(float speed);
 
 	//acceleration control based on assigning different speeds to different encoder regions
 	void move_up_interval();
 	void move_down_interval();
 
 	//acceleration control based on PID
+	//not used: the PIDController writes the pivot on its own and would fight the ArmController
 	void move_up_pid();
 	void move_down_pid();
 
@@ -52,8 +96,13 @@ public:
 	static const int FLOOR_POSITION = 50;
 	static const int LOW_GOAL_POSITION = 30; //TODO: determine this
 	static const int MINIMUM_FIRING_POSITION = 40;
+	static const float DEGREES_PER_TICK = 90.0f / (FLOOR_POSITION - TOP_POSITION);
+	//the roller is written when outputs is committed; the pivot belongs to the ArmController
+	//the encoder and the line break are read from sensors, which has to be latched each cycle
+	//its controller, calibration, profiles and so on go in arena (or the heap, without one)
 	Arm(Victor * roller_motor, Victor * pivot_motor, Encoder * enc, 
-			DigitalInput * floor, DigitalInput * top, DigitalInput * ball);
+			DigitalInput * floor, DigitalInput * top, DigitalInput * ball,
+			SensorFrame * sensors, OutputFrame * outputs, StaticArena * arena = NULL);
 	/*
 	 * Runs the roller in unless the linebreak has been hit
 	 * If the arm limit switch is hit, this will override the linebreak and allow the roller to spin
@@ -135,8 +184,13 @@ public:
 	void move_to_top();
 	/*
 	 * Returns true if the arm is at the top (ie, the limit switch is hit)
+	 * Latched by the switch's interrupt, so it doesn't read the switch
 	 */
 	bool at_top();
+	//encoder ticks from the top, as calibrated by the switches, as of the last latch
+	int get_position() { return position(); }
+	//the encoder's calibration, for its drift numbers
+	ArmCalibration * get_calibration() { return calibration; }
 	/*
 	 * Returns true if the arm is at the bottom (ie, the encoder is past a designated value)
 	 */
@@ -147,24 +201,43 @@ public:
 	bool can_fire();
 	/*
 	 * Returns true if a ball is captured (ie, the linebreak is broken)
+	 * at_bottom(), can_fire() and this read the sensor frame, so they hold still for the cycle
 	 */
 	bool ball_captured();
 	/*
 	 * Actually does pretty much everything
 	 * Almost nothing will work if you don't call this every cycle
 	 * So just stick it at the bottom of every periodic function and leave it alone
+	 * (or on a RateScheduler task, as the robot does)
 	 * If you've been reading all of these comments, you should know this by now
 	 */
 	void update();
+	/*
+	 * Starts a new command cycle: forgets this cycle's roller command and manual move
+	 * Call it before giving the commands for the cycle
+	 */
+	void begin_cycle();
 	
 	//deprecated
 	//use the ultra-fancy move_up_curved and move_down_curved instead
 	void move_up();
 	void move_down();
 	
-	//these not implemented yet
+	/*
+	 * Holds the arm where it is right now, on the position controller
+	 * Persistent, like set_position()
+	 */
 	void hold_position_pid();
-	void set_position(int pos); //position from 0 (top) to 60 (floor)
+	/*
+	 * Moves the arm to pos (TOP_POSITION to FLOOR_POSITION) on the position controller and holds it there
+	 * Persistent until override(), move_to_top(), move_to_bottom() or load_sequence()
+	 * Does nothing unless update() called in the same cycle
+	 */
+	void set_position(int pos);
+	/*
+	 * Returns true if set_position() has got the arm to where it was asked to go
+	 */
+	bool at_position();
 };
 
 
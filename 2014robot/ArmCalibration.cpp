@@ -0,0 +1,41 @@
+#include "ArmCalibration.h"
+#include <stdlib.h>
+
+ArmCalibration::ArmCalibration(Encoder * enc, int top, int floor) {
+	encoder = enc;
+	top_position = top;
+	floor_position = floor;
+	offset = encoder->Get() - top_position; //assume it started at the top, like it always has
+	rezeros = 0;
+	last_drift = 0;
+	worst_drift = 0;
+	top_raw = 0;
+	floor_raw = 0;
+	seen_top = false;
+	seen_floor = false;
+}
+
+void ArmCalibration::top_reached() {
+	rezero(top_position, top_raw);
+	seen_top = true;
+}
+
+void ArmCalibration::floor_reached() {
+	rezero(floor_position, floor_raw);
+	seen_floor = true;
+}
+
+void ArmCalibration::rezero(int known_position, INT32 &raw) {
+	raw = encoder->Get();
+	int drift = raw - offset - known_position;
+	offset = raw - known_position;
+	last_drift = drift;
+	if (abs(drift) > abs(worst_drift)) {
+		worst_drift = drift;
+	}
+	rezeros++;
+}
+
+int ArmCalibration::get_measured_span() {
+	return seen_top && seen_floor ? floor_raw - top_raw : 0;
+}
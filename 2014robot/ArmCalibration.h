@@ -0,0 +1,56 @@
+#ifndef ARMCALIBRATION_H_
+#define ARMCALIBRATION_H_
+
+#include "WPILib.h"
+
+/*
+ * The arm encoder, zeroed in software against the arm's limit switches
+ * The FPGA counter is never reset; instead an offset is subtracted from every read.
+ * top_reached() and floor_reached() are meant for the switches' closing edges (they're
+ * cheap and safe from an interrupt handler). Each one moves the offset so the position
+ * reads the switch's known position, once per edge, and keeps counting straight through
+ * switch bounce.
+ * Before moving the offset it notes how far off the position was (the drift since the
+ * last re-zero), and the worst drift seen is kept as a health metric: a slipping
+ * encoder or a loose switch shows up as drift well before the arm misses a position.
+ * The raw counts at the last top and floor edges give the measured top-to-floor span too,
+ * which should match the named positions.
+ * Positions are in encoder ticks, 0 at the top, bigger is lower, like Arm's constants.
+ */
+class ArmCalibration {
+public:
+	//top_position and floor_position are where the switches close, in ticks
+	ArmCalibration(Encoder * encoder, int top_position, int floor_position);
+	int get() { return encoder->Get() - offset; }
+	//what's subtracted from the raw count right now; a SensorFrame latches it with the count
+	INT32 get_offset() { return offset; }
+	//degrees per second, straight from the encoder (it isn't affected by the offset)
+	double get_rate() { return encoder->GetRate(); }
+	void top_reached();
+	void floor_reached();
+	//whether either switch has zeroed it since boot (until then it trusts the arm started at the top)
+	bool is_calibrated() { return rezeros > 0; }
+	UINT32 get_rezeros() { return rezeros; }
+	//position minus where the switch says it was, at the last re-zero
+	int get_last_drift() { return last_drift; }
+	//the largest last_drift (by size) since boot
+	int get_worst_drift() { return worst_drift; }
+	//raw ticks between the last top and floor edges; 0 until both have been seen
+	int get_measured_span();
+private:
+	Encoder * encoder;
+	int top_position;
+	int floor_position;
+	volatile INT32 offset;
+	volatile UINT32 rezeros;
+	volatile int last_drift;
+	volatile int worst_drift;
+	INT32 top_raw;
+	INT32 floor_raw;
+	bool seen_top;
+	bool seen_floor;
+
+	void rezero(int known_position, INT32 &raw);
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "ArmController.h"
+#include "MemoryBarrier.h"
+
+ArmController::ArmController(SpeedController * motor, ArmCalibration * encoder, float degrees_per_tick,
+		ArmProfile * profiles, double period, StaticArena * arena) {
+	this->motor = motor;
+	this->encoder = encoder;
+	this->profiles = profiles;
+	this->period = period;
+	ticks_per_degree = 1.0f / degrees_per_tick;
+	command_mode = OPEN_LOOP;
+	command_value = 0.0f;
+	command_number = 0;
+	write_count = 0;
+	mailbox_mode = OPEN_LOOP;
+	mailbox_value = 0.0f;
+	mailbox_ball = false;
+	current_command = 0;
+	profile_index = 0;
+	finished_command = 0;
+	cycles = 0;
+	upper_limit = false;
+	last_output = 0.0f;
+	loop_timer = new (arena) Notifier(ArmController::run, this);
+}
+
+void ArmController::start() {
+	loop_timer->StartPeriodic(period);
+}
+
+void ArmController::stop() {
+	loop_timer->Stop();
+}
+
+void ArmController::set_output(float output) {
+	if (command_mode != OPEN_LOOP || command_value != output) {
+		post(OPEN_LOOP, output);
+	}
+}
+
+void ArmController::set_position(float position) {
+	if (command_mode != POSITION || command_value != position) {
+		post(POSITION, position);
+	}
+}
+
+void ArmController::follow_profile(int profile, bool carrying_ball) {
+	if (profiles != NULL && profile >= 0) {
+		post(PROFILE, profile, carrying_ball);
+	}
+}
+
+bool ArmController::following_profile() {
+	return command_mode == PROFILE && finished_command != command_number;
+}
+
+void ArmController::post(control_mode mode, float value, bool ball) {
+	command_mode = mode;
+	command_value = value;
+	write_count++;
+	memory_barrier();
+	mailbox_mode = mode;
+	mailbox_value = value;
+	mailbox_ball = ball;
+	memory_barrier();
+	write_count++;
+	command_number = write_count >> 1;
+}
+
+void ArmController::run(void * controller) {
+	((ArmController *)controller)->step();
+}
+
+void ArmController::step() {
+	control_mode mode;
+	float value;
+	bool ball;
+	UINT32 before, after;
+	do {
+		before = write_count;
+		memory_barrier();
+		mode = mailbox_mode;
+		value = mailbox_value;
+		ball = mailbox_ball;
+		memory_barrier();
+		after = write_count;
+	} while ((before & 1) || before != after);
+	if (before >> 1 != current_command) {
+		current_command = before >> 1;
+		profile_index = 0; //a new command; start any profile from the beginning
+	}
+
+	if (mode == POSITION || mode == PROFILE) {
+		float target = value;
+		float target_speed = 0.0f;
+		float output = 0.0f;
+		if (mode == PROFILE) {
+			int profile = (int)value;
+			int last = profiles->get_length(profile) - 1;
+			const ArmProfile::sample &s = profiles->get_samples(profile)[profile_index];
+			target = s.position;
+			target_speed = s.velocity;
+			output = s.feed_forward + (ball ? s.ball_feed_forward : 0.0f);
+			if (profile_index < last) {
+				profile_index++;
+			} else {
+				finished_command = current_command; //stay on the last sample, holding there
+			}
+		}
+		float error = target - encoder->get();
+		float speed = encoder->get_rate() * ticks_per_degree;
+		output += KP * error + KD * (target_speed - speed);
+		if (output > MAX_OUTPUT) {
+			output = MAX_OUTPUT;
+		} else if (output < -MAX_OUTPUT) {
+			output = -MAX_OUTPUT;
+		}
+		drive(output);
+	} else {
+		drive(value);
+	}
+	cycles++;
+}
+
+void ArmController::drive(float output) {
+	if (upper_limit && output < 0.0f) {
+		output = 0.0f;
+	}
+	last_output = output;
+	motor->Set(output);
+	if (upper_limit && output < 0.0f) {
+		motor->Set(0.0f); //the switch closed between the check and the write
+		last_output = 0.0f;
+	}
+}
+
+void ArmController::upper_limit_hit() {
+	upper_limit = true;
+	memory_barrier();
+	if (last_output < 0.0f) {
+		motor->Set(0.0f);
+		last_output = 0.0f;
+	}
+}
+
+void ArmController::upper_limit_released() {
+	upper_limit = false;
+}
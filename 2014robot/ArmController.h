@@ -0,0 +1,97 @@
+#ifndef ARMCONTROLLER_H_
+#define ARMCONTROLLER_H_
+
+#include "WPILib.h"
+#include "ArmProfile.h"
+#include "ArmCalibration.h"
+#include "StaticArena.h"
+
+/*
+ * Runs the arm pivot motor from its own Notifier, at a fixed rate well above the 50 Hz
+ * the driver station packets give us
+ * Every period it reads the newest command from the main loop and either passes an
+ * open loop output straight through, runs a PD loop on the encoder to get to (and
+ * stay at) a position, or walks an ArmProfile one sample per period (PD on the
+ * profile's position and speed, plus its feed-forward) and then holds the end of it.
+ * This is the only thing that should Set() the pivot motor once it's started, so the
+ * two never fight over it.
+ * Commands go through a mailbox guarded by a sequence lock: the main loop writes, the
+ * Notifier reads and retries if it raced a write. Nobody ever blocks.
+ * Positions are in encoder ticks, like the constants in Arm (0 at the top, bigger is lower).
+ * Negative outputs drive the arm up. While the top limit is latched (see upper_limit_hit())
+ * nothing drives it any further up, whatever the command.
+ */
+class ArmController {
+public:
+	static const double DEFAULT_PERIOD = 0.005; //seconds, 200 Hz
+
+	//profiles may be null; they must have been built with the same period
+	//its Notifier goes in arena (or the heap, without one)
+	ArmController(SpeedController * motor, ArmCalibration * encoder, float degrees_per_tick,
+			ArmProfile * profiles = NULL, double period = DEFAULT_PERIOD, StaticArena * arena = NULL);
+	void start();
+	void stop();
+	//drive the motor at this output (-1 to 1) until told otherwise
+	void set_output(float output);
+	//go to and hold this position (ticks)
+	void set_position(float position);
+	/*
+	 * Follow profile number profile (from ArmProfile::find()), with the ball feed-forward
+	 * if carrying_ball. Restarts it if it's already the current command.
+	 */
+	void follow_profile(int profile, bool carrying_ball);
+	//true until the profile last asked for has been walked to the end
+	bool following_profile();
+	bool holding_position() { return command_mode == POSITION; }
+	float get_setpoint() { return command_value; }
+	//how many times the control loop has run
+	UINT32 get_cycles() { return cycles; }
+	/*
+	 * The top limit switch closed: cuts an upward output right away and holds off any more
+	 * until upper_limit_released(). Safe to call from an interrupt handler.
+	 */
+	void upper_limit_hit();
+	void upper_limit_released();
+	bool at_upper_limit() { return upper_limit; }
+private:
+	typedef enum {OPEN_LOOP, POSITION, PROFILE} control_mode;
+
+	static const float KP = 0.05f; //output per tick of error
+	static const float KD = 0.0015f; //output per tick per second of speed
+	static const float MAX_OUTPUT = 0.8f;
+
+	SpeedController * motor;
+	ArmCalibration * encoder;
+	Notifier * loop_timer;
+	ArmProfile * profiles;
+	double period;
+	float ticks_per_degree;
+
+	//main loop's copy of what it last sent, so it doesn't resend the same thing every cycle
+	control_mode command_mode;
+	float command_value;
+	UINT32 command_number; //write_count / 2 after the post
+
+	//the mailbox
+	volatile UINT32 write_count; //odd while a write is in progress
+	control_mode mailbox_mode;
+	float mailbox_value; //output, position, or profile number
+	bool mailbox_ball;
+
+	//the Notifier's side
+	UINT32 current_command;
+	int profile_index;
+	volatile UINT32 finished_command; //last PROFILE command walked to the end
+
+	volatile UINT32 cycles;
+
+	volatile bool upper_limit;
+	volatile float last_output; //what the motor was last set to
+
+	void post(control_mode mode, float value, bool ball = false);
+	void drive(float output);
+	static void run(void * controller);
+	void step();
+};
+
+#endif
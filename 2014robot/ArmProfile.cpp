@@ -0,0 +1,109 @@
+#include "ArmProfile.h"
+#include <math.h>
+#include <stdlib.h>
+
+ArmProfile::ArmProfile(const int * named_positions, int count, int top_position,
+		float degrees_per_tick, double period) {
+	if (count > MAX_POSITIONS) {
+		count = MAX_POSITIONS;
+	}
+	num_positions = count;
+	this->period = period;
+	radians_per_tick = degrees_per_tick * 3.1415926535f / 180.0f;
+	for (int i = 0; i < count; i++) {
+		positions[i] = named_positions[i];
+	}
+	for (int from = 0; from < count; from++) {
+		for (int to = 0; to < count; to++) {
+			int profile = from * MAX_POSITIONS + to;
+			bool up = positions[to] < positions[from];
+			generate(samples[profile], lengths[profile], positions[from], positions[to],
+					up ? MAX_SPEED_UP : MAX_SPEED_DOWN, ACCELERATION,
+					positions[to] == top_position ? TOP_DECELERATION : DECELERATION);
+		}
+	}
+}
+
+int ArmProfile::find(int from, int to, int tolerance) {
+	int i = named_position_near(from, tolerance);
+	int j = named_position_near(to, 0);
+	if (i < 0 || j < 0 || i == j) {
+		return -1;
+	}
+	return i * MAX_POSITIONS + j;
+}
+
+//index of the named position within tolerance ticks of pos, or -1
+int ArmProfile::named_position_near(int pos, int tolerance) {
+	for (int i = 0; i < num_positions; i++) {
+		if (abs(pos - positions[i]) <= tolerance) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+ * Samples the fastest trapezoid from rest at from to rest at to
+ * If the move is too short to reach max_speed, it peaks where the acceleration and
+ * deceleration ramps meet (a triangle). If it would take more than MAX_SAMPLES, the
+ * speed limit comes down until it fits.
+ */
+void ArmProfile::generate(sample * out, int &length, float from, float to, float max_speed,
+		float acceleration, float deceleration) {
+	float distance = fabsf(to - from);
+	float direction = to > from ? 1.0f : -1.0f;
+
+	float peak = max_speed;
+	if (distance < peak * peak * (0.5f / acceleration + 0.5f / deceleration)) {
+		peak = sqrtf(2.0f * distance * acceleration * deceleration / (acceleration + deceleration));
+	}
+	float accel_time = peak / acceleration;
+	float decel_time = peak / deceleration;
+	float cruise_time = 0.0f;
+	if (peak > 0.0f) {
+		cruise_time = (distance - 0.5f * peak * (accel_time + decel_time)) / peak;
+	}
+	float total_time = accel_time + cruise_time + decel_time;
+	float limit = (MAX_SAMPLES - 1) * period;
+	if (total_time > limit) {
+		//cruise slower: d = peak * (limit - peak/2a - peak/2d), solved for peak
+		float k = 0.5f / acceleration + 0.5f / deceleration;
+		peak = (limit - sqrtf(limit * limit - 4.0f * k * distance)) / (2.0f * k);
+		accel_time = peak / acceleration;
+		decel_time = peak / deceleration;
+		cruise_time = limit - accel_time - decel_time;
+		total_time = limit;
+	}
+
+	length = (int)ceilf(total_time / period) + 1;
+	for (int i = 0; i < length; i++) {
+		float t = i * period;
+		float travelled, speed, accel;
+		if (t >= total_time) {
+			travelled = distance;
+			speed = 0.0f;
+			accel = 0.0f;
+		} else if (t < accel_time) {
+			travelled = 0.5f * acceleration * t * t;
+			speed = acceleration * t;
+			accel = acceleration;
+		} else if (t < accel_time + cruise_time) {
+			travelled = 0.5f * peak * accel_time + peak * (t - accel_time);
+			speed = peak;
+			accel = 0.0f;
+		} else {
+			float left = total_time - t;
+			travelled = distance - 0.5f * deceleration * left * left;
+			speed = deceleration * left;
+			accel = -deceleration;
+		}
+		sample &s = out[i];
+		s.position = from + direction * travelled;
+		s.velocity = direction * speed;
+		//gravity pulls the arm down (more ticks), so holding it takes output towards the top
+		float lean = sinf(s.position * radians_per_tick);
+		s.feed_forward = KV * s.velocity + KA * direction * accel - ARM_GRAVITY * lean;
+		s.ball_feed_forward = -BALL_GRAVITY * lean;
+	}
+}
@@ -0,0 +1,66 @@
+#ifndef ARMPROFILE_H_
+#define ARMPROFILE_H_
+
+/*
+ * Precomputed trapezoidal motion profiles between the arm's named positions
+ * The constructor works out the fastest move from each position to every other one
+ * (accelerate, cruise, decelerate, within the limits below) and samples it once per
+ * controller period, with the feed-forward output for each sample: enough to hold the
+ * arm against gravity and to produce the profile's speed and acceleration. The ball
+ * adds its own gravity term, kept separately so either can be used at run time.
+ * After that, following a profile is just walking down a table.
+ * Moves that end at the top decelerate more gently, so the arm reaches the top switch
+ * slowly instead of slamming it.
+ * Positions are encoder ticks, 0 at the top (arm straight up), bigger is lower.
+ */
+class ArmProfile {
+public:
+	static const int MAX_POSITIONS = 4;
+	static const int MAX_SAMPLES = 256;
+
+	typedef struct {
+		float position;      //ticks
+		float velocity;      //ticks per second
+		float feed_forward;  //motor output for the arm alone
+		float ball_feed_forward; //extra output when carrying a ball
+	} sample;
+
+	/*
+	 * positions: the named positions, in ticks; top_position is the one with the switch
+	 */
+	ArmProfile(const int * positions, int num_positions, int top_position,
+			float degrees_per_tick, double period);
+	/*
+	 * Index of the profile from the named position within tolerance ticks of from, to the
+	 * named position to, or -1 if there isn't one
+	 */
+	int find(int from, int to, int tolerance = 0);
+	const sample * get_samples(int profile) { return samples[profile]; }
+	int get_length(int profile) { return lengths[profile]; }
+	//time to run the profile, seconds
+	float get_duration(int profile) { return lengths[profile] * period; }
+private:
+	//all in ticks, seconds and motor output
+	static const float MAX_SPEED_UP = 110.0f;
+	static const float MAX_SPEED_DOWN = 90.0f;
+	static const float ACCELERATION = 500.0f;
+	static const float DECELERATION = 500.0f;
+	static const float TOP_DECELERATION = 200.0f; //slowing down into the top switch
+	static const float KV = 0.006f; //output per tick per second
+	static const float KA = 0.0004f; //output per tick per second per second
+	static const float ARM_GRAVITY = 0.12f; //output to hold the arm out level
+	static const float BALL_GRAVITY = 0.08f; //and the extra with a ball in it
+
+	int positions[MAX_POSITIONS];
+	int num_positions;
+	float period;
+	float radians_per_tick;
+	sample samples[MAX_POSITIONS * MAX_POSITIONS][MAX_SAMPLES];
+	int lengths[MAX_POSITIONS * MAX_POSITIONS];
+
+	int named_position_near(int pos, int tolerance);
+	void generate(sample * out, int &length, float from, float to, float max_speed,
+			float acceleration, float deceleration);
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "AutonTimeline.h"
+#include <stdio.h>
+
+AutonTimeline::AutonTimeline(RobotDrive * drive, Arm * arm, Winch * winch, DigitalLED * led) {
+	this->drive = drive;
+	this->arm = arm;
+	this->winch = winch;
+	this->led = led;
+	current = NULL;
+	active_tracks = 0;
+	for (int t = 0; t < NUM_TRACKS; t++) {
+		track_length[t] = 0;
+		cursor[t] = 0;
+	}
+}
+
+AutonTimeline::track AutonTimeline::track_of(action a) {
+	switch (a) {
+		case ARCADE_DRIVE:
+			return DRIVE;
+		case ARM_DROP_BALL_IN:
+		case ARM_LOAD_SEQUENCE:
+		case ARM_MOVE_TO_BOTTOM:
+		case ARM_MOVE_TO_TOP:
+			return ARM;
+		case WINCH_WIND_BACK:
+		case WINCH_FIRE:
+			return WINCH;
+		case LED_COLOR:
+		default:
+			return LED;
+	}
+}
+
+int AutonTimeline::load(const routine &r) {
+	static const char * track_names[NUM_TRACKS] = {"drive", "arm", "winch", "LED"};
+	int problems = 0;
+	current = &r;
+	for (int t = 0; t < NUM_TRACKS; t++) {
+		track_length[t] = 0;
+	}
+
+	//sort each track's steps by start time (insertion sort; routines are short and this is startup)
+	for (int i = 0; i < r.num_steps; i++) {
+		const step * s = &r.steps[i];
+		track t = track_of(s->what);
+		if (s->end <= s->start) {
+			printf("auton %s: %s step at %.2fs ends before it starts\n", r.name, track_names[t], s->start);
+			problems++;
+		}
+		if (track_length[t] == MAX_STEPS_PER_TRACK) {
+			printf("auton %s: too many %s steps, dropping the one at %.2fs\n", r.name, track_names[t], s->start);
+			problems++;
+			continue;
+		}
+		int j = track_length[t]++;
+		while (j > 0 && tracks[t][j - 1]->start > s->start) {
+			tracks[t][j] = tracks[t][j - 1];
+			j--;
+		}
+		tracks[t][j] = s;
+	}
+
+	for (int t = 0; t < NUM_TRACKS; t++) {
+		for (int i = 1; i < track_length[t]; i++) {
+			if (tracks[t][i]->start < tracks[t][i - 1]->end) {
+				printf("auton %s: %s steps at %.2fs and %.2fs overlap\n", r.name, track_names[t],
+						tracks[t][i - 1]->start, tracks[t][i]->start);
+				problems++;
+			}
+		}
+	}
+	start();
+	return problems;
+}
+
+void AutonTimeline::start() {
+	for (int t = 0; t < NUM_TRACKS; t++) {
+		cursor[t] = 0;
+	}
+	active_tracks = 0;
+}
+
+void AutonTimeline::update(double time_s) {
+	active_tracks = 0;
+	for (int t = 0; t < NUM_TRACKS; t++) {
+		//skip past finished steps; across the whole routine this moves each cursor once per step
+		while (cursor[t] < track_length[t] && tracks[t][cursor[t]]->end <= time_s) {
+			cursor[t]++;
+		}
+		if (cursor[t] == track_length[t]) {
+			continue;
+		}
+		const step &s = *tracks[t][cursor[t]];
+		if (s.start <= time_s && condition_holds(s.when)) {
+			run(s);
+			active_tracks |= 1 << t;
+		}
+	}
+}
+
+bool AutonTimeline::condition_holds(condition c) {
+	switch (c) {
+		case WHEN_ARM_CAN_FIRE:
+			return arm->can_fire();
+		case WHEN_BALL_CAPTURED:
+			return arm->ball_captured();
+		case ALWAYS:
+		default:
+			return true;
+	}
+}
+
+void AutonTimeline::run(const step &s) {
+	switch (s.what) {
+		case ARCADE_DRIVE:
+			drive->ArcadeDrive(s.a, s.b);
+			break;
+		case ARM_DROP_BALL_IN:
+			arm->drop_ball_in();
+			break;
+		case ARM_LOAD_SEQUENCE:
+			arm->load_sequence();
+			break;
+		case ARM_MOVE_TO_BOTTOM:
+			arm->move_to_bottom();
+			break;
+		case ARM_MOVE_TO_TOP:
+			arm->move_to_top();
+			break;
+		case WINCH_WIND_BACK:
+			winch->wind_back();
+			break;
+		case WINCH_FIRE:
+			winch->fire();
+			break;
+		case LED_COLOR:
+			led->Set((DigitalLED::rgb_color)s.a);
+			break;
+	}
+}
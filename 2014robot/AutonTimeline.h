@@ -0,0 +1,87 @@
+#ifndef AUTONTIMELINE_H_
+#define AUTONTIMELINE_H_
+
+#include "WPILib.h"
+#include "Arm.h"
+#include "Winch.h"
+#include "DigitalLED.h"
+#include "LoopProfiler.h"
+
+/*
+ * Runs an autonomous routine written as a table of timed steps
+ * Each step says: between start and end seconds, every cycle, do this action (if its
+ * condition holds). Every action belongs to one track (drive, arm, winch or LEDs);
+ * tracks run in parallel, but only one step per track can be active at a time.
+ * load() sorts each track's steps by start time and checks that none of them overlap,
+ * printing any that do, so a routine that asks for two things at once from the same
+ * actuator is caught at startup instead of on the field.
+ * Each track keeps a cursor into its steps, and a cycle only ever looks at the step under
+ * each cursor, so update() costs the same however long the routine is.
+ * Anything a step doesn't command is left alone: give the drive an explicit stop step
+ * rather than relying on the motors timing out.
+ */
+class AutonTimeline {
+public:
+	typedef enum {DRIVE, ARM, WINCH, LED, NUM_TRACKS} track;
+	typedef enum {
+		ARCADE_DRIVE,   //a = speed, b = turn
+		ARM_DROP_BALL_IN,
+		ARM_LOAD_SEQUENCE,
+		ARM_MOVE_TO_BOTTOM,
+		ARM_MOVE_TO_TOP,
+		WINCH_WIND_BACK,
+		WINCH_FIRE,
+		LED_COLOR       //a = DigitalLED color
+	} action;
+	typedef enum {ALWAYS, WHEN_ARM_CAN_FIRE, WHEN_BALL_CAPTURED} condition;
+
+	typedef struct {
+		float start; //seconds from the start of autonomous
+		float end;   //the step stops being active at this time
+		action what;
+		float a, b;
+		condition when;
+	} step;
+
+	typedef struct {
+		const char * name;
+		const step * steps;
+		int num_steps;
+		LoopProfiler::mode profiler_mode;
+	} routine;
+
+	static const float END_OF_AUTON = 15.0f; //end time for steps that last the rest of autonomous
+	static const int MAX_STEPS_PER_TRACK = 16;
+
+	AutonTimeline(RobotDrive * drive, Arm * arm, Winch * winch, DigitalLED * led);
+	/*
+	 * Makes r the routine to run, and checks it
+	 * Returns the number of problems found (overlapping steps, steps that end before they
+	 * start, too many steps on a track), printing each one
+	 */
+	int load(const routine &r);
+	//back to the start of the routine; call from AutonomousInit
+	void start();
+	//does whatever is scheduled for time_s seconds in; time must not go backwards between starts
+	void update(double time_s);
+	const routine * get_routine() { return current; }
+	//true if the track did something this cycle
+	bool track_active(track t) { return (active_tracks >> t) & 1; }
+	static track track_of(action a);
+private:
+	RobotDrive * drive;
+	Arm * arm;
+	Winch * winch;
+	DigitalLED * led;
+
+	const routine * current;
+	const step * tracks[NUM_TRACKS][MAX_STEPS_PER_TRACK];
+	int track_length[NUM_TRACKS];
+	int cursor[NUM_TRACKS];
+	unsigned active_tracks;
+
+	bool condition_holds(condition c);
+	void run(const step &s);
+};
+
+#endif
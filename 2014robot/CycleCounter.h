@@ -0,0 +1,66 @@
+#ifndef CYCLECOUNTER_H_
+#define CYCLECOUNTER_H_
+
+#include "WPILib.h"
+#ifndef __vxworks
+#include <time.h>
+#endif
+
+/*
+ * The cheapest timestamp the CPU has: the PowerPC time base on the cRIO, the TSC on a PC.
+ * Reading it is a single instruction, so it can be left in the control loop.
+ * The tick rate is not fixed, so compare tick counts against reference_seconds()
+ * over a long interval to convert them to real time.
+ */
+namespace CycleCounter {
+
+//low 32 bits of the counter; differences are correct across wraparound as long as
+//the interval is shorter than a wrap (minutes on the cRIO, about a second on a PC)
+inline UINT32 ticks() {
+#if defined(__PPC__) || defined(__powerpc__)
+	UINT32 lo;
+	asm volatile("mftb %0" : "=r"(lo));
+	return lo;
+#elif defined(__i386__) || defined(__x86_64__)
+	UINT32 lo, hi;
+	asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+	return lo;
+#else
+	return GetFPGATime();
+#endif
+}
+
+//the full counter, for calibrating over long intervals
+inline UINT64 ticks64() {
+#if defined(__PPC__) || defined(__powerpc__)
+	UINT32 hi, lo, hi2;
+	do {
+		asm volatile("mftbu %0" : "=r"(hi));
+		asm volatile("mftb %0" : "=r"(lo));
+		asm volatile("mftbu %0" : "=r"(hi2));
+	} while (hi != hi2);
+	return ((UINT64)hi << 32) | lo;
+#elif defined(__i386__) || defined(__x86_64__)
+	UINT32 lo, hi;
+	asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+	return ((UINT64)hi << 32) | lo;
+#else
+	return GetFPGATime();
+#endif
+}
+
+//wall-clock seconds to calibrate against. On the robot that's the FPGA clock;
+//in the simulation the FPGA clock is virtual, so use the host's clock instead.
+inline double reference_seconds() {
+#ifdef __vxworks
+	return GetFPGATime() * 1.0e-6;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+#endif
+}
+
+}
+
+#endif
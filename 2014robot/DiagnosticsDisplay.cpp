@@ -0,0 +1,97 @@
+#include "DiagnosticsDisplay.h"
+
+DiagnosticsDisplay::DiagnosticsDisplay(DriverStationLCD * driver_station_lcd, float update_rate,
+		StaticArena * arena) {
+	lcd = driver_station_lcd;
+	update_period = 1.0f / update_rate;
+	for (int i = 0; i < NUM_LINES; i++) {
+		lines[i].kind = TEXT;
+		lines[i].format = "";
+		lines[i].int_value = 0;
+		lines[i].float_values[0] = 0.0f;
+		lines[i].float_values[1] = 0.0f;
+	}
+	dirty_lines = 0;
+	sending_lines = 0;
+	timer = new (arena) Timer();
+	timer->Start();
+}
+
+void DiagnosticsDisplay::print(DriverStationLCD::Line line, const char * text) {
+	set_line(line, TEXT, text, 0, 0.0f, 0.0f);
+}
+
+void DiagnosticsDisplay::print_int(DriverStationLCD::Line line, const char * format, int value) {
+	set_line(line, INT, format, value, 0.0f, 0.0f);
+}
+
+void DiagnosticsDisplay::print_float(DriverStationLCD::Line line, const char * format, float value) {
+	set_line(line, FLOAT, format, 0, value, 0.0f);
+}
+
+void DiagnosticsDisplay::print_floats(DriverStationLCD::Line line, const char * format, float value1, float value2) {
+	set_line(line, TWO_FLOATS, format, 0, value1, value2);
+}
+
+void DiagnosticsDisplay::clear() {
+	for (int i = 0; i < NUM_LINES; i++) {
+		print((DriverStationLCD::Line)i, "");
+	}
+}
+
+void DiagnosticsDisplay::set_line(DriverStationLCD::Line line, line_kind kind, const char * format,
+		int int_value, float value1, float value2) {
+	line_state &state = lines[line];
+	if (state.kind == kind && state.format == format && state.int_value == int_value
+			&& state.float_values[0] == value1 && state.float_values[1] == value2) {
+		return; //nothing changed, nothing to do
+	}
+	state.kind = kind;
+	state.format = format;
+	state.int_value = int_value;
+	state.float_values[0] = value1;
+	state.float_values[1] = value2;
+	dirty_lines |= 1 << line;
+}
+
+void DiagnosticsDisplay::update() {
+	if (sending_lines == 0) {
+		if (dirty_lines == 0 || timer->Get() < update_period) {
+			return;
+		}
+		sending_lines = dirty_lines;
+	}
+
+	for (int i = 0; i < NUM_LINES; i++) {
+		if (sending_lines & (1 << i)) {
+			format_line(i);
+			sending_lines &= ~(1 << i);
+			dirty_lines &= ~(1 << i);
+			break;
+		}
+	}
+
+	if (sending_lines == 0) {
+		lcd->UpdateLCD();
+		timer->Reset();
+	}
+}
+
+void DiagnosticsDisplay::format_line(int line) {
+	line_state &state = lines[line];
+	DriverStationLCD::Line lcd_line = (DriverStationLCD::Line)line;
+	switch (state.kind) {
+		case TEXT:
+			lcd->PrintfLine(lcd_line, "%s", state.format);
+			break;
+		case INT:
+			lcd->PrintfLine(lcd_line, state.format, state.int_value);
+			break;
+		case FLOAT:
+			lcd->PrintfLine(lcd_line, state.format, state.float_values[0]);
+			break;
+		case TWO_FLOATS:
+			lcd->PrintfLine(lcd_line, state.format, state.float_values[0], state.float_values[1]);
+			break;
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef DIAGNOSTICSDISPLAY_H_
+#define DIAGNOSTICSDISPLAY_H_
+
+#include "WPILib.h"
+#include "StaticArena.h"
+
+/*
+ * Change-detecting, rate-limited front end for the driver station LCD
+ * The print functions only remember the format and the values; nothing is formatted
+ * unless a line's inputs actually changed since it was last sent.
+ * update() (call it once per cycle) sends the changed lines to the LCD at most
+ * update_rate times a second, formatting at most one line per cycle so the
+ * vsnprintf cost is spread out instead of landing on the control loop all at once.
+ * Format strings should be string literals; they're compared by pointer.
+ */
+class DiagnosticsDisplay {
+public:
+	static const float DEFAULT_UPDATE_RATE = 5.0f; //Hz
+
+	//its timer goes in arena (or the heap, without one)
+	DiagnosticsDisplay(DriverStationLCD * driver_station_lcd, float update_rate = DEFAULT_UPDATE_RATE,
+			StaticArena * arena = NULL);
+	void print(DriverStationLCD::Line line, const char * text);
+	void print_int(DriverStationLCD::Line line, const char * format, int value);
+	void print_float(DriverStationLCD::Line line, const char * format, float value);
+	void print_floats(DriverStationLCD::Line line, const char * format, float value1, float value2);
+	//blanks every line, sent with the next update
+	void clear();
+	/*
+	 * Once per update period, picks up the lines that changed, then formats one of them
+	 * per call and pushes the LCD after the last one.
+	 */
+	void update();
+private:
+	typedef enum {TEXT, INT, FLOAT, TWO_FLOATS} line_kind;
+	typedef struct {
+		line_kind kind;
+		const char * format;
+		int int_value;
+		float float_values[2];
+	} line_state;
+
+	static const int NUM_LINES = 6;
+
+	DriverStationLCD * lcd;
+	Timer * timer;
+	float update_period;
+	line_state lines[NUM_LINES];
+	unsigned dirty_lines;   //bitmask, lines changed since they were last formatted
+	unsigned sending_lines; //bitmask, lines still to be formatted for the current push
+
+	void set_line(DriverStationLCD::Line line, line_kind kind, const char * format,
+			int int_value, float value1, float value2);
+	void format_line(int line);
+};
+
+#endif
@@ -1,9 +1,11 @@
 #include "DigitalLED.h"
 
-DigitalLED::DigitalLED(DigitalOutput * red, DigitalOutput * green, DigitalOutput * blue) {
-	red_channel = red;
-	green_channel = green;
-	blue_channel = blue;
+DigitalLED::DigitalLED(DigitalOutput * red, DigitalOutput * green, DigitalOutput * blue, OutputFrame * frame) {
+	outputs = frame;
+	red_channel = outputs->add(red);
+	green_channel = outputs->add(green);
+	blue_channel = outputs->add(blue);
+	color = OFF;
 }
 
 void DigitalLED::Set(DigitalLED::rgb_color color) {
@@ -11,7 +13,8 @@ void DigitalLED::Set(DigitalLED::rgb_color color) {
 }
 
 void DigitalLED::Set(bool red, bool green, bool blue){
-	red_channel->Set(red);
-	green_channel->Set(green);
-	blue_channel->Set(blue);
+	outputs->set(red_channel, red);
+	outputs->set(green_channel, green);
+	outputs->set(blue_channel, blue);
+	color = (red ? RED : OFF) | (green ? GREEN : OFF) | (blue ? BLUE : OFF);
 }
@@ -2,12 +2,14 @@
 #define DIGITALLED_H_
 
 #include "WPILib.h"
+#include "OutputFrame.h"
 
 class DigitalLED {
 private:
-	DigitalOutput * red_channel;
-	DigitalOutput * green_channel;
-	DigitalOutput * blue_channel;
+	OutputFrame * outputs;
+	int red_channel;
+	int green_channel;
+	int blue_channel;
 public:
 	typedef char rgb_color;
 	//colors are represented as a bitmap
@@ -21,9 +23,14 @@ public:
 	static const rgb_color CYAN = GREEN | BLUE;
 	static const rgb_color WHITE = RED | GREEN | BLUE;
 	static const rgb_color OFF = 0;
-	DigitalLED(DigitalOutput * red, DigitalOutput * green, DigitalOutput * blue);
+	//the channels are written when outputs is committed
+	DigitalLED(DigitalOutput * red, DigitalOutput * green, DigitalOutput * blue, OutputFrame * outputs);
 	void Set(rgb_color color);
 	void Set(bool red, bool green, bool blue);
+	//the color last set
+	rgb_color Get() { return color; }
+private:
+	rgb_color color;
 };
 
 #endif
@@ -0,0 +1,51 @@
+#include "DriveShaper.h"
+
+DriveShaper::DriveShaper(StaticArena * arena) : speed_limiter(SPEED_ACCELERATION, SPEED_DECELERATION),
+		turn_limiter(TURN_ACCELERATION, TURN_DECELERATION) {
+	speed_curve.build(DriveShaper::shape_speed, -1.0f, 1.0f);
+	turn_curve.build(DriveShaper::shape_turn, -1.0f, 1.0f);
+	timer = new (arena) Timer();
+	timer->Start();
+}
+
+void DriveShaper::update(float stick_speed, float stick_turn, float &speed, float &turn,
+		float speed_scale, float turn_scale) {
+	float dt = timer->Get();
+	timer->Reset();
+	if (dt > MAX_DT) {
+		dt = MAX_DT;
+	}
+	speed = speed_limiter.update(speed_scale * look_up(speed_curve, stick_speed), dt);
+	turn = turn_limiter.update(turn_scale * look_up(turn_curve, stick_turn), dt);
+}
+
+void DriveShaper::reset() {
+	speed_limiter.reset();
+	turn_limiter.reset();
+	timer->Reset();
+}
+
+/*
+ * Nothing inside the deadband, then the rest of the stick's travel rescaled to 0-1 and
+ * blended between linear and cubic
+ */
+float DriveShaper::shape(float x, float expo) {
+	float magnitude = fabsf(x);
+	if (magnitude <= DEADBAND) {
+		return 0.0f;
+	}
+	float u = (magnitude - DEADBAND) / (1.0f - DEADBAND);
+	float y = (1.0f - expo) * u + expo * u * u * u;
+	return x < 0.0f ? -y : y;
+}
+
+float DriveShaper::look_up(InterpolatedTable<CURVE_POINTS> &curve, float x) {
+	if (x > 1.0f) {
+		x = 1.0f;
+	} else if (x < -1.0f) {
+		x = -1.0f;
+	}
+	float y = 0.0f;
+	curve.lookup(x, y); //can't fail: x is on the table and the curve is finite everywhere
+	return y;
+}
@@ -0,0 +1,85 @@
+#ifndef DRIVESHAPER_H_
+#define DRIVESHAPER_H_
+
+#include "WPILib.h"
+#include "InterpolatedTable.h"
+#include "StaticArena.h"
+
+/*
+ * Limits how fast a value can change, in units per second
+ * Getting bigger (away from 0) is limited by the acceleration rate, getting smaller (towards 0
+ * or through it) by the deceleration rate. Pass in the real time since the last update, so
+ * it does the same thing whatever the loop rate and however much the loop jitters.
+ */
+class SlewLimiter {
+public:
+	SlewLimiter(float acceleration, float deceleration) {
+		accel_rate = acceleration;
+		decel_rate = deceleration;
+		value = 0.0f;
+	}
+	float update(float target, float dt) {
+		bool speeding_up = (target >= 0.0f) == (value >= 0.0f) && fabsf(target) > fabsf(value);
+		float max_delta = (speeding_up ? accel_rate : decel_rate) * dt;
+		float delta = target - value;
+		if (delta > max_delta) {
+			delta = max_delta;
+		} else if (delta < -max_delta) {
+			delta = -max_delta;
+		}
+		value += delta;
+		return value;
+	}
+	void reset(float to = 0.0f) { value = to; }
+	float get() { return value; }
+private:
+	float accel_rate;
+	float decel_rate;
+	float value;
+};
+
+/*
+ * Turns the pilot's sticks into drive commands
+ * Each axis goes through a response curve (a deadband, then expo so small movements are
+ * fine and full stick is still full power), looked up from a table built at startup,
+ * then a slew limiter with its own acceleration and deceleration rates.
+ * The time between updates is measured, not assumed from GetLoopsPerSec().
+ */
+class DriveShaper {
+public:
+	//its timer goes in arena (or the heap, without one)
+	DriveShaper(StaticArena * arena = NULL);
+	/*
+	 * Shapes one cycle's stick values (-1 to 1) into speed and turn for ArcadeDrive(), with its
+	 * squaring turned off: these are the motor powers, so the curves are the only shaping
+	 * The scales are applied after the curves and before the limiters, eg to cap power in safety mode
+	 */
+	void update(float stick_speed, float stick_turn, float &speed, float &turn,
+			float speed_scale = 1.0f, float turn_scale = 1.0f);
+	//start from a standstill, and don't count the time since the last update (call in the Inits)
+	void reset();
+private:
+	static const float DEADBAND = 0.05f;
+	//0 is linear, 1 is cubic; 0.6 is close to the squared inputs ArcadeDrive() used to apply
+	static const float SPEED_EXPO = 0.6f;
+	static const float TURN_EXPO = 0.6f;
+	static const float SPEED_ACCELERATION = 1.0f / 0.3f; //full speed in 0.3 seconds
+	static const float SPEED_DECELERATION = 1.0f / 0.3f;
+	static const float TURN_ACCELERATION = 1.0f / 0.15f;
+	static const float TURN_DECELERATION = 1.0f / 0.1f;
+	static const float MAX_DT = 0.1f; //a longer gap than this is a hiccup, not time to accelerate in
+	static const int CURVE_POINTS = 129; //so 0 is exactly on a point
+
+	InterpolatedTable<CURVE_POINTS> speed_curve;
+	InterpolatedTable<CURVE_POINTS> turn_curve;
+	SlewLimiter speed_limiter;
+	SlewLimiter turn_limiter;
+	Timer * timer;
+
+	static float shape(float x, float expo);
+	static float shape_speed(float x) { return shape(x, SPEED_EXPO); }
+	static float shape_turn(float x) { return shape(x, TURN_EXPO); }
+	static float look_up(InterpolatedTable<CURVE_POINTS> &curve, float x);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include "Gamepad.h"
 #include "DriverStation.h"
 #include "Utility.h"
+#include "MemoryBarrier.h"
 
 /**
  * Construct an instance of a Gamepad.
@@ -10,11 +11,21 @@
  */
 Gamepad::Gamepad(UINT32 port) : Joystick(port)
 {
-	for (int i = 0; i < 12; i++){
-		buttons_pressed[i] = false;
-	}
+	polled_buttons = 0;
+	pressed_edges = 0;
+	released_edges = 0;
+	event_queue_enabled = false;
+	event_queue_polled = false;
+	event_buttons = 0;
+	event_head = 0;
+	event_tail = 0;
     a_port = port;
     ap_ds = DriverStation::GetInstance();
+    snapshot_mode = false;
+    frame.buttons = 0;
+    for (UINT32 i = 0; i <= kNumAxes; i++){
+        frame.axes[i] = 0.0f;
+    }
 }
 
 Gamepad::~Gamepad()
@@ -61,6 +72,8 @@ float Gamepad::GetRightY()
  */
 float Gamepad::GetRawAxis(UINT32 axis)
 {
+    if (snapshot_mode && axis >= 1 && axis <= kNumAxes)
+        return frame.axes[axis];
     return ap_ds->GetStickAxis(a_port, axis);
 }
 
@@ -99,21 +112,48 @@ float Gamepad::GetAxis(AxisType axis)
  **/
 bool Gamepad::GetNumberedButton(UINT32 button)
 {
-    bool val = ((0x1 << (button-1)) & ap_ds->GetStickButtons(a_port)) != 0;
-    buttons_pressed[button] = val;
+    if (button < 1 || button > kNumButtons)
+        return false;
+    UINT16 mask = 0x1 << (button-1);
+    if (snapshot_mode)
+        return (frame.buttons & mask) != 0;
+    bool val = (ap_ds->GetStickButtons(a_port) & mask) != 0;
+    polled_buttons = val ? (polled_buttons | mask) : (polled_buttons & ~mask);
     return val;
 }
 
+/**
+ * Whether the button went down since the previous frame.
+ *
+ * In snapshot mode the edges for every button are computed once in Latch(), so this
+ * can be asked any number of times (or not at all) in a cycle without missing or
+ * repeating an edge. Otherwise it compares against the last time this button was read.
+ */
 bool Gamepad::GetNumberedButtonPressed(UINT32 button)
 {
-	bool prev_pressed = buttons_pressed[button];
-	return  GetNumberedButton(button) && !prev_pressed;
+    if (button < 1 || button > kNumButtons)
+        return false;
+    UINT16 mask = 0x1 << (button-1);
+    if (snapshot_mode)
+        return (pressed_edges & mask) != 0;
+    bool prev_pressed = (polled_buttons & mask) != 0;
+    return GetNumberedButton(button) && !prev_pressed;
 }
 
+/**
+ * Whether the button came up since the previous frame.
+ *
+ * @see GetNumberedButtonPressed
+ */
 bool Gamepad::GetNumberedButtonReleased(UINT32 button)
 {
-	bool prev_pressed = buttons_pressed[button];
-	return !GetNumberedButton(button) && prev_pressed;
+    if (button < 1 || button > kNumButtons)
+        return false;
+    UINT16 mask = 0x1 << (button-1);
+    if (snapshot_mode)
+        return (released_edges & mask) != 0;
+    bool prev_pressed = (polled_buttons & mask) != 0;
+    return !GetNumberedButton(button) && prev_pressed;
 }
 
 /**
@@ -161,3 +201,116 @@ Gamepad::DPadDirection Gamepad::GetDPad()
   return kCenter;
 }
 
+/**
+ * Turn snapshot mode on or off.
+ *
+ * In snapshot mode every accessor reads the frame captured by the last call to
+ * Latch() instead of asking the driver station, so each one is a plain memory
+ * read and every decision in a cycle sees the same inputs. Call Latch() once at
+ * the top of each periodic function.
+ *
+ * @param enabled True to read from the latched frame.
+ */
+void Gamepad::SetSnapshotMode(bool enabled)
+{
+    snapshot_mode = enabled;
+}
+
+/**
+ * Copy the buttons and all the axes from the driver station into the frame.
+ *
+ * This is one driver station query per axis plus one for the buttons, no matter
+ * how many times the values get read afterwards.
+ */
+void Gamepad::Latch()
+{
+    UINT16 previous = frame.buttons;
+    frame.buttons = ap_ds->GetStickButtons(a_port);
+    for (UINT32 i = 1; i <= kNumAxes; i++){
+        frame.axes[i] = ap_ds->GetStickAxis(a_port, i);
+    }
+
+    //one XOR finds every button that changed; split by direction
+    UINT16 changed = frame.buttons ^ previous;
+    pressed_edges = changed & frame.buttons;
+    released_edges = changed & previous;
+
+    if (event_queue_enabled && !event_queue_polled)
+        QueueEdges(frame.buttons);
+}
+
+/**
+ * Turn the button event queue on or off.
+ *
+ * With the queue on, every button edge is queued with a timestamp. The queue has
+ * exactly one producer: Latch(), or with polled set, PollEvents() alone (Latch() then
+ * leaves the queue alone). Polling faster than the loop (from a Notifier, for example)
+ * catches a press and release that both happen between two loops. The queue holds
+ * kEventQueueLength events; when it's full, new events are dropped.
+ * Call this before the producer starts, not while it's running.
+ *
+ * @param enabled True to start queueing events.
+ * @param polled True if PollEvents() will be the one queueing them.
+ */
+void Gamepad::SetEventQueueEnabled(bool enabled, bool polled)
+{
+    event_buttons = ap_ds->GetStickButtons(a_port);
+    event_queue_polled = polled;
+    memory_barrier(); //a poller that sees the queue on sees the rest too
+    event_queue_enabled = enabled;
+}
+
+/**
+ * Read the buttons and queue any edges since the last read.
+ *
+ * Does nothing unless the queue was enabled with polled set. Doesn't touch the
+ * latched frame. Safe to call from one other task while the robot task reads events:
+ * it's then the queue's only producer, and only the producer moves the tail.
+ */
+void Gamepad::PollEvents()
+{
+    if (event_queue_enabled && event_queue_polled)
+        QueueEdges(ap_ds->GetStickButtons(a_port));
+}
+
+/**
+ * Take the oldest event off the queue.
+ *
+ * @param event Filled in with the event, if there is one.
+ * @return False if the queue is empty.
+ */
+bool Gamepad::GetNextEvent(ButtonEvent &event)
+{
+    int head = event_head;
+    if (head == event_tail)
+        return false;
+    memory_barrier(); //read the event only after seeing the tail that published it
+    event = events[head];
+    memory_barrier(); //done with the slot before the producer can reuse it
+    event_head = (head + 1) % kEventQueueLength;
+    return true;
+}
+
+void Gamepad::QueueEdges(UINT16 buttons)
+{
+    UINT32 changed = buttons ^ event_buttons;
+    event_buttons = buttons;
+    if (changed == 0)
+        return;
+    UINT32 now = GetFPGATime();
+    while (changed != 0){
+        int bit = __builtin_ctz(changed);
+        changed &= changed - 1;
+
+        int tail = event_tail;
+        int next = (tail + 1) % kEventQueueLength;
+        if (next == event_head)
+            return; //full
+        memory_barrier(); //the consumer is done with the slot before we write it
+        events[tail].timestamp = now;
+        events[tail].button = bit + 1;
+        events[tail].pressed = (buttons & (0x1 << bit)) != 0;
+        memory_barrier(); //the event has to be there before the consumer can see it
+        event_tail = next;
+    }
+}
@@ -14,8 +14,44 @@ class DriverStation;
  */
 class Gamepad : public Joystick
 {
+public:
+    static const UINT32 kNumAxes = 6;
+    static const UINT32 kNumButtons = 16;
+    static const int kEventQueueLength = 16;
+
+    /**
+     * Everything read from the gamepad in one cycle.
+     */
+    typedef struct
+    {
+        UINT16 buttons; //bit (n - 1) is button n
+        float axes[kNumAxes + 1]; //indexed by axis number, 1 through 6
+    } InputFrame;
+
+    /**
+     * A button changing state, as seen by Latch() or PollEvents() (whichever is queueing).
+     */
+    typedef struct
+    {
+        UINT32 timestamp; //FPGA time in microseconds
+        UINT8 button;
+        bool pressed; //false if released
+    } ButtonEvent;
+
 private:
-	bool buttons_pressed[12];
+	UINT16 polled_buttons; //state last seen by each button query, when not in snapshot mode
+	bool snapshot_mode;
+	InputFrame frame;
+	UINT16 pressed_edges;
+	UINT16 released_edges;
+
+	bool event_queue_enabled;
+	bool event_queue_polled; //PollEvents() is the producer, rather than Latch()
+	UINT16 event_buttons; //state last seen by the event queue; only the producer touches it
+	ButtonEvent events[kEventQueueLength];
+	volatile int event_head; //written only by the consumer
+	volatile int event_tail; //written only by the producer
+	void QueueEdges(UINT16 buttons);
 public:
 	static const int LEFT_BUMPER = 5;
 	static const int RIGHT_BUMPER = 6;
@@ -28,6 +64,8 @@ public:
 	static const int F310_Y = 4;
 	static const int F310_LB = 5;
 	static const int F310_RB = 6;
+	static const int F310_BACK = 7;
+	static const int F310_START = 8;
 	static const int F310_L_STICK = 9;
 	static const int F310_R_STICK = 10;
 	
@@ -68,6 +106,16 @@ public:
 
     DPadDirection GetDPad();
 
+    void SetSnapshotMode(bool enabled);
+    void Latch();
+    const InputFrame & GetFrame() { return frame; }
+    UINT16 GetPressedEdges() { return pressed_edges; }
+    UINT16 GetReleasedEdges() { return released_edges; }
+
+    void SetEventQueueEnabled(bool enabled, bool polled = false);
+    void PollEvents();
+    bool GetNextEvent(ButtonEvent &event);
+
 protected:
     static const UINT32 kLeftXAxisNum = 1;
     static const UINT32 kLeftYAxisNum = 2;
@@ -0,0 +1,95 @@
+#ifndef INTERPOLATEDTABLE_H_
+#define INTERPOLATEDTABLE_H_
+
+#include <math.h>
+
+/*
+ * A curve sampled at N evenly spaced points, linearly interpolated between them
+ * build() evaluates the curve once at every point (do it at startup, it's the slow part).
+ * After that lookup() is a subtract, a multiply, and a multiply-add, with no trig.
+ * Points where the curve isn't a real number (NaN or infinite, eg a negative sqrt) are
+ * marked invalid, and any lookup that would interpolate from one returns false.
+ * Fixed size, no allocation; keep it as a plain member.
+ */
+template <int N>
+class InterpolatedTable {
+public:
+	typedef float (*curve)(float x);
+
+	InterpolatedTable() {
+		x_min = 0.0f;
+		x_max = 0.0f;
+		inverse_step = 0.0f;
+		for (int i = 0; i < MASK_WORDS; i++) {
+			valid_mask[i] = 0;
+		}
+	}
+
+	/*
+	 * Samples f at N points from min to max, inclusive
+	 */
+	void build(curve f, float min, float max) {
+		x_min = min;
+		x_max = max;
+		inverse_step = (N - 1) / (max - min);
+		float step = (max - min) / (N - 1);
+
+		float y[N];
+		for (int i = 0; i < N; i++) {
+			y[i] = f(min + i * step);
+		}
+		for (int i = 0; i < MASK_WORDS; i++) {
+			valid_mask[i] = 0;
+		}
+		for (int i = 0; i < N - 1; i++) {
+			bool valid = finite(y[i]) && finite(y[i + 1]);
+			base[i] = valid ? y[i] : 0.0f;
+			slope[i] = valid ? y[i + 1] - y[i] : 0.0f;
+			valid_mask[i >> 5] |= (unsigned)valid << (i & 31);
+		}
+	}
+
+	/*
+	 * Interpolated value of the curve at x
+	 * Returns false (and leaves y alone) if x is outside the table or the curve isn't
+	 * defined there.
+	 */
+	bool lookup(float x, float &y) {
+		float t = (x - x_min) * inverse_step;
+		if (!(t >= 0.0f && t <= N - 1)) {
+			return false; //also catches a NaN x
+		}
+		int i = (int)t;
+		i -= i == N - 1; //x_max itself uses the last segment
+		if (!((valid_mask[i >> 5] >> (i & 31)) & 1)) {
+			return false;
+		}
+		y = base[i] + slope[i] * (t - i);
+		return true;
+	}
+
+	//how many of the N - 1 segments are usable
+	int valid_segments() {
+		int count = 0;
+		for (int i = 0; i < MASK_WORDS; i++) {
+			count += __builtin_popcount(valid_mask[i]);
+		}
+		return count;
+	}
+
+	float get_min() { return x_min; }
+	float get_max() { return x_max; }
+private:
+	static const int MASK_WORDS = (N + 31) / 32;
+
+	float x_min;
+	float x_max;
+	float inverse_step;
+	float base[N - 1];  //curve value at the start of each segment
+	float slope[N - 1]; //change across each segment
+	unsigned valid_mask[MASK_WORDS];
+
+	static bool finite(float v) { return v == v && fabsf(v) <= 3.0e38f; }
+};
+
+#endif
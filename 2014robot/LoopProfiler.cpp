@@ -0,0 +1,176 @@
+#include "LoopProfiler.h"
+#include <stdio.h>
+#include <string.h>
+
+LatencyHistogram::LatencyHistogram() {
+	reset();
+}
+
+void LatencyHistogram::reset() {
+	memset(buckets, 0, sizeof(buckets));
+	count = 0;
+	max = 0;
+}
+
+UINT32 LatencyHistogram::bucket_upper_edge(int index) {
+	if (index < SUB_BUCKETS) {
+		return index;
+	}
+	int octave = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+	int sub_bucket = index % SUB_BUCKETS;
+	UINT64 edge = ((UINT64)(SUB_BUCKETS + sub_bucket + 1) << (octave - SUB_BUCKET_BITS)) - 1;
+	return edge > 0xFFFFFFFFu ? 0xFFFFFFFFu : (UINT32)edge;
+}
+
+UINT32 LatencyHistogram::percentile(float fraction) {
+	if (count == 0) {
+		return 0;
+	}
+	UINT32 target = (UINT32)(fraction * count);
+	if (target >= count) {
+		target = count - 1;
+	}
+	UINT32 seen = 0;
+	for (int i = 0; i < NUM_BUCKETS; i++) {
+		seen += buckets[i];
+		if (seen > target) {
+			UINT32 edge = bucket_upper_edge(i);
+			return edge < max ? edge : max; //never report more than we actually saw
+		}
+	}
+	return max;
+}
+
+LoopProfiler::LoopProfiler() {
+	current_mode = DISABLED;
+	memset(start_ticks, 0, sizeof(start_ticks));
+	memset(last_ticks, 0, sizeof(last_ticks));
+	budget = DEFAULT_BUDGET;
+	budget_ticks = 0xFFFFFFFFu;
+	creation_ticks = CycleCounter::ticks64();
+	creation_seconds = CycleCounter::reference_seconds();
+	total_overruns = 0;
+	last_overrun_stage = LOOP;
+	reset();
+}
+
+void LoopProfiler::set_mode(mode m) {
+	current_mode = m;
+	calibrate_budget();
+}
+
+void LoopProfiler::set_budget(double seconds) {
+	budget = seconds;
+	calibrate_budget();
+}
+
+void LoopProfiler::calibrate_budget() {
+	double elapsed = CycleCounter::reference_seconds() - creation_seconds;
+	if (elapsed < 1.0) {
+		return; //too short to trust; keep whatever we had
+	}
+	double ticks = budget * (CycleCounter::ticks64() - creation_ticks) / elapsed;
+	budget_ticks = ticks < 4294967295.0 ? (UINT32)ticks : 0xFFFFFFFFu;
+}
+
+void LoopProfiler::overrun(UINT32 loop_ticks) {
+	total_overruns++;
+	if (loop_ticks > worst_overrun_ticks[current_mode]) {
+		worst_overrun_ticks[current_mode] = loop_ticks;
+	}
+	//only stages that started inside this loop count
+	stage blamed = LOOP;
+	INT64 worst_excess = 0;
+	for (int s = 0; s < LOOP; s++) {
+		if ((UINT32)(start_ticks[s] - start_ticks[LOOP]) > loop_ticks) {
+			continue;
+		}
+		INT64 excess = (INT64)last_ticks[s] - histograms[current_mode][s].percentile(0.5f);
+		if (excess > worst_excess) {
+			worst_excess = excess;
+			blamed = (stage)s;
+		}
+	}
+	overruns[current_mode][blamed]++;
+	last_overrun_stage = blamed;
+}
+
+void LoopProfiler::reset() {
+	for (int m = 0; m < NUM_MODES; m++) {
+		for (int s = 0; s < NUM_STAGES; s++) {
+			histograms[m][s].reset();
+		}
+	}
+	memset(overruns, 0, sizeof(overruns));
+	memset(worst_overrun_ticks, 0, sizeof(worst_overrun_ticks));
+	calibration_ticks = CycleCounter::ticks64();
+	calibration_seconds = CycleCounter::reference_seconds();
+}
+
+void LoopProfiler::dump() {
+	double elapsed = CycleCounter::reference_seconds() - calibration_seconds;
+	UINT64 elapsed_ticks = CycleCounter::ticks64() - calibration_ticks;
+	if (elapsed <= 0.0 || elapsed_ticks == 0) {
+		return;
+	}
+	double us_per_tick = elapsed * 1.0e6 / elapsed_ticks;
+
+	for (int m = 0; m < NUM_MODES; m++) {
+		if (histograms[m][LOOP].get_count() == 0) {
+			continue;
+		}
+		printf("loop profile: %s, %u loops (us)\n", mode_name((mode)m), histograms[m][LOOP].get_count());
+		printf("  %-12s %9s %9s %9s\n", "stage", "p50", "p99", "max");
+		for (int s = 0; s < NUM_STAGES; s++) {
+			LatencyHistogram &h = histograms[m][s];
+			if (h.get_count() == 0) {
+				continue;
+			}
+			printf("  %-12s %9.1f %9.1f %9.1f\n", stage_name((stage)s),
+					h.percentile(0.5f) * us_per_tick,
+					h.percentile(0.99f) * us_per_tick,
+					h.get_max() * us_per_tick);
+		}
+		UINT32 mode_overruns = 0;
+		for (int s = 0; s < NUM_STAGES; s++) {
+			mode_overruns += overruns[m][s];
+		}
+		if (mode_overruns == 0) {
+			continue;
+		}
+		printf("  %u over the %.1f ms budget, worst %.1f ms; blamed on:", mode_overruns, budget * 1.0e3,
+				worst_overrun_ticks[m] * us_per_tick * 1.0e-3);
+		for (int s = 0; s < NUM_STAGES; s++) {
+			if (overruns[m][s] > 0) {
+				printf(" %s %u", stage_name((stage)s), overruns[m][s]);
+			}
+		}
+		printf("\n");
+	}
+	reset();
+}
+
+const char * LoopProfiler::stage_name(stage s) {
+	switch (s) {
+		case INPUT: return "input";
+		case DRIVE: return "drive";
+		case COMMANDS: return "commands";
+		case LCD: return "lcd";
+		case TELEMETRY: return "telemetry";
+		case LOOP: return "whole loop";
+		default: return "?";
+	}
+}
+
+const char * LoopProfiler::mode_name(mode m) {
+	switch (m) {
+		case DISABLED: return "disabled";
+		case TELEOP: return "teleop";
+		case SAFETY_TEST: return "safety test";
+		case COLOR_TEST: return "color test";
+		case AUTON_MAIN: return "auton main";
+		case AUTON_TWO_BALL: return "auton two ball";
+		case AUTON_DRIVE_FORWARD: return "auton drive forward";
+		default: return "?";
+	}
+}
@@ -0,0 +1,130 @@
+#ifndef LOOPPROFILER_H_
+#define LOOPPROFILER_H_
+
+#include "WPILib.h"
+#include "CycleCounter.h"
+
+/*
+ * Fixed-size, log-bucketed histogram of tick counts
+ * Each power of two is split into 4 buckets, so any percentile is accurate to within ~19%
+ * Recording is a count-leading-zeros and an increment, no allocation, no floating point
+ */
+class LatencyHistogram {
+public:
+	static const int SUB_BUCKET_BITS = 2;
+	static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	static const int NUM_BUCKETS = 32 * SUB_BUCKETS;
+
+	LatencyHistogram();
+	void reset();
+	inline void record(UINT32 ticks) {
+		buckets[bucket_index(ticks)]++;
+		count++;
+		if (ticks > max) {
+			max = ticks;
+		}
+	}
+	UINT32 get_count() { return count; }
+	UINT32 get_max() { return max; }
+	/*
+	 * Upper edge of the bucket holding the given fraction of samples, in ticks
+	 * ie percentile(0.99) is the p99 latency, rounded up to the bucket edge
+	 */
+	UINT32 percentile(float fraction);
+private:
+	UINT32 buckets[NUM_BUCKETS];
+	UINT32 count;
+	UINT32 max;
+
+	static inline int bucket_index(UINT32 ticks) {
+		if (ticks < SUB_BUCKETS) {
+			return ticks;
+		}
+		int octave = 31 - __builtin_clz(ticks); //position of the highest set bit
+		int sub_bucket = (ticks >> (octave - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+		return (octave - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+	}
+	static UINT32 bucket_upper_edge(int index);
+};
+
+/*
+ * Times each stage of the periodic functions with the CPU cycle counter
+ * Keeps one histogram per stage per mode, so we can see which stage eats the loop budget
+ * Call set_mode() from each Init, then wrap each stage of the periodic function in
+ * start(stage) and stop(stage). Wrap the whole function in start(LOOP) and stop(LOOP).
+ * A probe is two counter reads and a histogram increment, well under a microsecond,
+ * so it stays on in matches.
+ * dump() prints p50/p99/max for everything recorded since the last dump, then clears it.
+ *
+ * It also watches a deadline: set_budget() gives the longest a whole loop may take,
+ * and any LOOP longer than that is an overrun. An overrun is blamed on the stage that ran
+ * furthest over its own median that cycle (or the whole loop, if none of them did,
+ * meaning the time went somewhere unprofiled). Checking costs nothing beyond the stage
+ * timestamps already taken; the blame is only worked out when there's an overrun.
+ */
+class LoopProfiler {
+public:
+	typedef enum {INPUT, DRIVE, COMMANDS, LCD, TELEMETRY, LOOP, NUM_STAGES} stage;
+	typedef enum {DISABLED, TELEOP, SAFETY_TEST, COLOR_TEST,
+		AUTON_MAIN, AUTON_TWO_BALL, AUTON_DRIVE_FORWARD, NUM_MODES} mode;
+
+	static const double DEFAULT_BUDGET = 0.02; //seconds, one driver station packet
+
+	LoopProfiler();
+	//also recalibrates the budget, so call it from each Init
+	void set_mode(mode m);
+	mode get_mode() { return current_mode; }
+	inline void start(stage s) {
+		start_ticks[s] = CycleCounter::ticks();
+	}
+	inline void stop(stage s) {
+		UINT32 elapsed = CycleCounter::ticks() - start_ticks[s];
+		last_ticks[s] = elapsed;
+		histograms[current_mode][s].record(elapsed);
+		if (s == LOOP && elapsed > budget_ticks) {
+			overrun(elapsed);
+		}
+	}
+	/*
+	 * The longest a loop may take, in seconds
+	 * The cycle counter's rate has to be measured first, so overruns aren't counted
+	 * until a set_mode() at least a second after the profiler was made.
+	 */
+	void set_budget(double seconds);
+	//overruns since the profiler was made
+	UINT32 get_overruns() { return total_overruns; }
+	//the stage blamed for the latest overrun (LOOP if there hasn't been one)
+	stage get_last_overrun_stage() { return last_overrun_stage; }
+	static const char * stage_name(stage s);
+	/*
+	 * Prints the histograms to the console, in microseconds
+	 * Modes with nothing recorded are skipped
+	 * Clears everything afterwards, so each dump covers one match (or one mode)
+	 */
+	void dump();
+	void reset();
+private:
+	mode current_mode;
+	UINT32 start_ticks[NUM_STAGES];
+	UINT32 last_ticks[NUM_STAGES]; //each stage's most recent time
+	LatencyHistogram histograms[NUM_MODES][NUM_STAGES];
+
+	//for converting ticks to microseconds
+	UINT64 calibration_ticks;
+	double calibration_seconds;
+
+	double budget;
+	UINT32 budget_ticks; //all ones until the tick rate is known
+	UINT64 creation_ticks; //the tick rate is measured over everything since creation
+	double creation_seconds;
+	UINT32 total_overruns;
+	UINT32 overruns[NUM_MODES][NUM_STAGES]; //since the last dump, by the stage blamed
+	UINT32 worst_overrun_ticks[NUM_MODES];
+	stage last_overrun_stage;
+
+	void calibrate_budget();
+	void overrun(UINT32 loop_ticks);
+	static const char * mode_name(mode m);
+};
+
+#endif
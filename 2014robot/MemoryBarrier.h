@@ -0,0 +1,16 @@
+#ifndef MEMORYBARRIER_H_
+#define MEMORYBARRIER_H_
+
+/*
+ * Keeps the compiler (and on the PowerPC, the CPU) from moving loads and stores across it
+ * For the sequence locks between the main loop and Notifier/interrupt code.
+ */
+inline void memory_barrier() {
+#if defined(__PPC__) || defined(__powerpc__)
+	asm volatile("sync" ::: "memory");
+#else
+	asm volatile("" ::: "memory");
+#endif
+}
+
+#endif
@@ -0,0 +1,63 @@
+#include "OutputFrame.h"
+
+OutputFrame::OutputFrame() {
+	num_channels = 0;
+	dirty = 0;
+	writes = 0;
+}
+
+int OutputFrame::add(SpeedController * controller) {
+	return add(SPEED_CONTROLLER, controller, controller->Get());
+}
+
+int OutputFrame::add(Solenoid * solenoid) {
+	return add(SOLENOID, solenoid, solenoid->Get());
+}
+
+int OutputFrame::add(DoubleSolenoid * solenoid) {
+	return add(DOUBLE_SOLENOID, solenoid, solenoid->Get());
+}
+
+//there's no reading a digital output back, so its first set() always writes
+int OutputFrame::add(DigitalOutput * output) {
+	return add(DIGITAL_OUTPUT, output, -1.0f);
+}
+
+int OutputFrame::add(output_kind kind, void * output, float initial) {
+	if (num_channels >= MAX_CHANNELS) {
+		return -1;
+	}
+	int channel = num_channels++;
+	kinds[channel] = kind;
+	outputs[channel] = output;
+	staged[channel] = initial;
+	written[channel] = initial;
+	return channel;
+}
+
+int OutputFrame::commit() {
+	int count = 0;
+	while (dirty != 0) {
+		int channel = __builtin_ctz(dirty);
+		dirty &= dirty - 1;
+		float value = staged[channel];
+		switch (kinds[channel]) {
+			case SPEED_CONTROLLER:
+				((SpeedController *)outputs[channel])->Set(value);
+				break;
+			case SOLENOID:
+				((Solenoid *)outputs[channel])->Set(value != 0.0f);
+				break;
+			case DOUBLE_SOLENOID:
+				((DoubleSolenoid *)outputs[channel])->Set((DoubleSolenoid::Value)(int)value);
+				break;
+			case DIGITAL_OUTPUT:
+				((DigitalOutput *)outputs[channel])->Set(value != 0.0f);
+				break;
+		}
+		written[channel] = value;
+		count++;
+	}
+	writes += count;
+	return count;
+}
@@ -0,0 +1,57 @@
+#ifndef OUTPUTFRAME_H_
+#define OUTPUTFRAME_H_
+
+#include "WPILib.h"
+
+/*
+ * Collects a cycle's actuator commands and writes them out together
+ * Register each output once with add(), which returns its channel number. During the
+ * cycle, set() only stages a value; the last one set wins, however many times it was
+ * set. commit() then writes just the channels whose staged value differs from what was
+ * last written, once each, so an output that doesn't change costs nothing and an output
+ * set twice in a cycle never glitches through the first value.
+ * Whoever owns the frame commits it at the end of each cycle. Not thread safe: the
+ * setters and the committer need to share a lock (the robot uses the RateScheduler's).
+ * Outputs that have to be cut from an interrupt handler (the winch motor, the arm pivot)
+ * aren't in here; those are written directly, where the interrupt can see them.
+ */
+class OutputFrame {
+public:
+	static const int MAX_CHANNELS = 16;
+
+	OutputFrame();
+	int add(SpeedController * controller);
+	int add(Solenoid * solenoid);
+	int add(DoubleSolenoid * solenoid);
+	int add(DigitalOutput * output);
+	//stages a value: speed for a controller, 0 or 1 for a solenoid or a digital output,
+	//a DoubleSolenoid::Value for a double solenoid
+	inline void set(int channel, float value) {
+		staged[channel] = value;
+		if (value != written[channel]) {
+			dirty |= 1 << channel;
+		} else {
+			dirty &= ~(1 << channel);
+		}
+	}
+	//the staged value, what the output will be after the next commit
+	float get(int channel) { return staged[channel]; }
+	//writes every channel that changed, returns how many
+	int commit();
+	//hardware writes since construction
+	UINT32 get_writes() { return writes; }
+private:
+	typedef enum {SPEED_CONTROLLER, SOLENOID, DOUBLE_SOLENOID, DIGITAL_OUTPUT} output_kind;
+
+	output_kind kinds[MAX_CHANNELS];
+	void * outputs[MAX_CHANNELS];
+	float staged[MAX_CHANNELS];
+	float written[MAX_CHANNELS];
+	int num_channels;
+	UINT32 dirty; //bitmask, channels staged to something other than what was written
+	UINT32 writes;
+
+	int add(output_kind kind, void * output, float initial);
+};
+
+#endif
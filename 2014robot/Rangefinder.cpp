@@ -2,60 +2,60 @@
 #include <cmath>
 
 
-Rangefinder::Rangefinder(Ultrasonic * us){
-	ultrasonic = us;
-	ultrasonic->SetEnabled(true);
-	Ultrasonic::SetAutomaticMode(true);
-	invalid_count = 0;
-	for(int i=0; i<ARRAY_LENGTH; i++){
-		distance_group[i] = 0;
-	}
-	current_array_point = 0;
+Rangefinder::Rangefinder(RangingScheduler * ranging, int sensor_index, int second_sensor_index){
+	scheduler = ranging;
+	sensor = sensor_index;
+	second_sensor = second_sensor_index;
+	last_sequence = 0;
+	invalid_count = MAX_INVALID + 1; //nothing measured yet
+	sample_history = 0;
+	second_distance = 0.0f;
+	current.distance = 0.0f;
+	current.timestamp = 0.0;
+	current.valid = false;
+	current.confidence = 0.0f;
 }
 
 void Rangefinder::update(){
-	if(distance_state==0){
-		ultrasonic->Ping();
-		distance_state=1;
-		counter=0;
-	}else if(distance_state==1){
-		if(ultrasonic->IsRangeValid()){
-			distance = ultrasonic->GetRangeInches();
-			distance_state=0;
-			counter=0;
-			
-			if(distance>200){//throw out bad values
-				invalid_count++;
-			}else{
-				invalid_count = 0;
-				distance_group[current_array_point] = distance;
-				current_array_point++;
-				if(current_array_point>=ARRAY_LENGTH){
-					current_array_point = 0;
-				}
-			}
-			
-		}else if(counter++>3){
-			distance_state=0;
-		}
-	}else{
-		distance_state=0;
-		counter=0;
+	RangingScheduler::sample latest;
+	if (scheduler->get_latest(sensor, latest) && latest.sequence != last_sequence){
+		last_sequence = latest.sequence;
+		add_sample(latest.distance, latest.timestamp);
+	}
+	if (second_sensor >= 0 && scheduler->get_latest(second_sensor, latest)){
+		second_distance = latest.distance;
+	}
+}
+
+void Rangefinder::add_sample(float distance, double timestamp){
+	float filtered;
+	bool accepted = filter.update(distance, filtered);
+	sample_history = (sample_history << 1) | accepted;
+	if (accepted){
+		invalid_count = 0;
+		current.distance = filtered;
+		current.timestamp = timestamp;
+	} else {
+		invalid_count++;
 	}
+	current.confidence = (float)__builtin_popcount(sample_history & ((1 << CONFIDENCE_SAMPLES) - 1))
+			/ CONFIDENCE_SAMPLES;
 }
 
 //return distance between robot and nearest surface
 float Rangefinder::Get(){
-	
-	if(invalid_count>ARRAY_LENGTH){//cannot get good reading
-		return -1.0;
-	}else{//can get good reading
-		//return avg from dist group
-		float sum = 0;
-		for (int i=0; i<ARRAY_LENGTH; i++){
-			sum+=distance_group[i];
-		}
-		return sum/ARRAY_LENGTH;
+	return current.distance;
+}
+
+Rangefinder::reading Rangefinder::GetReading(){
+	current.valid = invalid_count <= MAX_INVALID
+			&& Timer::GetFPGATimestamp() - current.timestamp < MAX_AGE;
+	return current;
+}
+
+float Rangefinder::robot_angle(){
+	if (second_sensor < 0){
+		return 0.0f;
 	}
-	
+	return atan2f(second_distance - current.distance, SENSOR_DISTANCE);
 }
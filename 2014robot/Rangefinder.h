@@ -2,22 +2,64 @@
 #define RANGEFINDER_H_
 
 #include "WPILib.h"
+#include "StreamingFilters.h"
+#include "RangingScheduler.h"
 
 class Rangefinder {
+public:
+	/*
+	 * A filtered distance, with when it was measured and how much to trust it
+	 */
+	typedef struct {
+		float distance;   //inches
+		double timestamp; //FPGA time of the newest sample that went into it, in seconds
+		bool valid;       //false if we haven't had a good sample recently
+		float confidence; //fraction of the recent samples that passed the gates, 0 to 1
+	} reading;
 private:
-	static const int ARRAY_LENGTH = 4;
 	static const float SENSOR_DISTANCE = 1.0f; //distance between the two sensors, in inches
-	Ultrasonic * ultrasonic;
-    int distance_state;
-    int counter;
-    float distance;
-    float distance_group[ARRAY_LENGTH];
-    int current_array_point;
+	static const int MIN_RANGE = 1;            //inches; anything outside this is noise
+	static const int MAX_RANGE = 200;
+	static const int MAX_INVALID = 4;          //bad samples in a row before the reading goes invalid
+	static const double MAX_AGE = 0.5;         //seconds before an old reading goes invalid
+	static const int CONFIDENCE_SAMPLES = 8;
+
+	//range gate, then a median of 3 to drop single bad echoes, then a mean of 4
+	typedef FilterChain<RangeGate<MIN_RANGE, MAX_RANGE>,
+			FilterChain<MovingMedian<3>, MovingAverage<4> > > distance_filter;
+
+	RangingScheduler * scheduler;
+	int sensor;
+	int second_sensor;
+    UINT32 last_sequence;
+    distance_filter filter;
+    reading current;
     int invalid_count;
+    UINT32 sample_history; //one bit per recent sample, 1 if it was accepted
+    float second_distance;
+
+    void add_sample(float distance, double timestamp);
 public:
-	Rangefinder(Ultrasonic * us);
+	/*
+	 * Takes its samples from the given sensor(s) on the scheduler
+	 * With a second sensor (mounted SENSOR_DISTANCE to the side) robot_angle() works too
+	 */
+	Rangefinder(RangingScheduler * ranging, int sensor_index, int second_sensor_index = -1);
+	/*
+	 * Angle to the surface in front of us, in radians, from the difference between the two sensors
+	 * 0 if there's only one sensor
+	 */
 	float robot_angle();
+	/*
+	 * The last filtered distance in inches, whether or not it's still valid
+	 * Use GetReading() if you need to know
+	 */
 	float Get();
+	reading GetReading();
+	/*
+	 * Picks up any new samples from the scheduler and runs them through the filters
+	 * Cheap; the pinging happens on the scheduler's own timer
+	 */
 	void update();
 };
 
@@ -0,0 +1,92 @@
+#include "RangingScheduler.h"
+#include "MemoryBarrier.h"
+
+RangingScheduler::RangingScheduler(double ping_period, StaticArena * arena) {
+	period = ping_period;
+	num_sensors = 0;
+	next_sensor = 0;
+	timeouts = 0;
+	Ultrasonic::SetAutomaticMode(false); //automatic mode would ping over the top of us
+	ping_timer = new (arena) Notifier(RangingScheduler::ping_next, this);
+}
+
+int RangingScheduler::add_sensor(Ultrasonic * ultrasonic, DigitalInput * echo) {
+	if (num_sensors >= MAX_SENSORS) {
+		return -1;
+	}
+	sensor_slot &slot = sensors[num_sensors];
+	slot.ultrasonic = ultrasonic;
+	slot.echo = echo;
+	slot.scheduler = this;
+	slot.write_count = 0;
+	slot.distance = 0.0f;
+	slot.timestamp = 0.0;
+	slot.sequence = 0;
+	slot.echo_pending = false;
+
+	ultrasonic->SetEnabled(true);
+	echo->RequestInterrupts(RangingScheduler::echo_received, &slot);
+	echo->SetUpSourceEdge(false, true); //the echo is over when the line drops
+	echo->EnableInterrupts();
+	return num_sensors++;
+}
+
+void RangingScheduler::start() {
+	if (num_sensors > 0) {
+		ping_timer->StartPeriodic(period);
+	}
+}
+
+void RangingScheduler::stop() {
+	ping_timer->Stop();
+}
+
+void RangingScheduler::ping_next(void * scheduler) {
+	RangingScheduler * self = (RangingScheduler *)scheduler;
+	sensor_slot &slot = self->sensors[self->next_sensor];
+	if (slot.echo_pending) {
+		self->timeouts++; //the last ping on this sensor never came back
+	}
+	slot.echo_pending = true;
+	slot.ultrasonic->Ping();
+	self->next_sensor = (self->next_sensor + 1) % self->num_sensors;
+}
+
+void RangingScheduler::echo_received(UINT32 mask, void * param) {
+	sensor_slot &slot = *(sensor_slot *)param;
+	if (!slot.echo_pending) {
+		return;
+	}
+	slot.echo_pending = false;
+	if (slot.ultrasonic->IsRangeValid()) {
+		slot.scheduler->publish(slot, slot.ultrasonic->GetRangeInches(), slot.echo->ReadInterruptTimestamp());
+	}
+}
+
+void RangingScheduler::publish(sensor_slot &slot, float distance, double timestamp) {
+	slot.write_count++;
+	memory_barrier();
+	slot.distance = distance;
+	slot.timestamp = timestamp;
+	slot.sequence++;
+	memory_barrier();
+	slot.write_count++;
+}
+
+bool RangingScheduler::get_latest(int sensor, sample &out) {
+	if (sensor < 0 || sensor >= num_sensors) {
+		return false;
+	}
+	sensor_slot &slot = sensors[sensor];
+	UINT32 before, after;
+	do {
+		before = slot.write_count;
+		memory_barrier();
+		out.distance = slot.distance;
+		out.timestamp = slot.timestamp;
+		out.sequence = slot.sequence;
+		memory_barrier();
+		after = slot.write_count;
+	} while ((before & 1) || before != after);
+	return out.sequence != 0;
+}
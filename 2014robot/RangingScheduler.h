@@ -0,0 +1,70 @@
+#ifndef RANGINGSCHEDULER_H_
+#define RANGINGSCHEDULER_H_
+
+#include "WPILib.h"
+#include "StaticArena.h"
+
+/*
+ * Pings the ultrasonic sensors on its own timer, independent of the robot loop
+ * A Notifier fires every ping_period seconds and pings the next sensor in turn, so
+ * sensors never hear each other's echoes. When the echo line drops, an interrupt on
+ * the echo input reads the range (the FPGA counter has already timed the pulse) and
+ * publishes it with the FPGA timestamp of the edge.
+ * Readers get the newest sample for a sensor through a sequence lock: the interrupt
+ * side never waits, and a reader just retries if it raced a write. No locks, no
+ * allocation after construction.
+ * Don't use Ultrasonic::SetAutomaticMode() alongside this; the constructor turns it off.
+ */
+class RangingScheduler {
+public:
+	static const int MAX_SENSORS = 4;
+	static const double DEFAULT_PING_PERIOD = 0.03; //seconds; long enough for a 200 inch echo
+
+	typedef struct {
+		float distance;   //inches
+		double timestamp; //FPGA time of the echo, seconds
+		UINT32 sequence;  //goes up by one for every new sample from this sensor
+	} sample;
+
+	//its Notifier goes in arena (or the heap, without one)
+	RangingScheduler(double ping_period = DEFAULT_PING_PERIOD, StaticArena * arena = NULL);
+	/*
+	 * Registers a sensor, returns its index (or -1 if there's no room)
+	 * The echo input must be the same one the Ultrasonic was built with.
+	 * Call before start().
+	 */
+	int add_sensor(Ultrasonic * ultrasonic, DigitalInput * echo);
+	void start();
+	void stop();
+	/*
+	 * Copies the newest sample for the sensor into out
+	 * Returns false if the sensor hasn't produced a sample yet
+	 */
+	bool get_latest(int sensor, sample &out);
+	//pings that never got an echo back, across all sensors
+	UINT32 get_timeouts() { return timeouts; }
+private:
+	typedef struct {
+		Ultrasonic * ultrasonic;
+		DigitalInput * echo;
+		RangingScheduler * scheduler;
+		volatile UINT32 write_count; //odd while a write is in progress
+		float distance;
+		double timestamp;
+		UINT32 sequence;
+		volatile bool echo_pending;
+	} sensor_slot;
+
+	Notifier * ping_timer;
+	double period;
+	sensor_slot sensors[MAX_SENSORS];
+	int num_sensors;
+	int next_sensor;
+	UINT32 timeouts;
+
+	static void ping_next(void * scheduler);
+	static void echo_received(UINT32 mask, void * slot);
+	void publish(sensor_slot &slot, float distance, double timestamp);
+};
+
+#endif
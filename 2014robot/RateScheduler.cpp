@@ -0,0 +1,156 @@
+#include "RateScheduler.h"
+#include "MemoryBarrier.h"
+#include <stdio.h>
+
+RateScheduler::RateScheduler(double rate, StaticArena * arena) {
+	base_rate = rate;
+	budget_us = (UINT32)(TICK_BUDGET * 1.0e6 / rate);
+	num_tasks = 0;
+	active = 0;
+	tick_count = 0;
+	busy_ticks = 0;
+	tick_begin = NULL;
+	tick_begin_param = NULL;
+	tick_end = NULL;
+	tick_end_param = NULL;
+	task_lock = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE);
+	tick_timer = new (arena) Notifier(RateScheduler::tick, this);
+}
+
+RateScheduler::task_set RateScheduler::add(const char * name, task_function function, void * param,
+		double rate, int priority) {
+	if (num_tasks >= MAX_TASKS) {
+		return 0;
+	}
+	task t;
+	t.name = name;
+	t.function = function;
+	t.param = param;
+	t.priority = priority;
+	t.period_ticks = (UINT32)(base_rate / rate + 0.5);
+	if (t.period_ticks < 1) {
+		t.period_ticks = 1;
+	}
+	t.next_tick = 0;
+	t.runs = 0;
+	t.deferred = 0;
+	t.skipped = 0;
+	t.total_us = 0;
+	t.max_us = 0;
+	task_set bit = 1 << num_tasks;
+
+	//insert in priority order; equal priorities keep the order they were added in
+	int i = num_tasks;
+	for (; i > 0 && tasks[i - 1].priority > priority; i--) {
+		tasks[i] = tasks[i - 1];
+		task_bits[i] = task_bits[i - 1];
+	}
+	tasks[i] = t;
+	task_bits[i] = bit;
+	num_tasks++;
+	return bit;
+}
+
+void RateScheduler::set_active(task_set tasks_to_run) {
+	for (int i = 0; i < num_tasks; i++) {
+		if ((tasks_to_run & task_bits[i]) && !(active & task_bits[i])) {
+			tasks[i].next_tick = tick_count + 1;
+		}
+	}
+	memory_barrier(); //a tick that sees the new bit sees its next_tick too
+	active = tasks_to_run;
+}
+
+void RateScheduler::set_tick_begin(task_function function, void * param) {
+	tick_begin = function;
+	tick_begin_param = param;
+}
+
+void RateScheduler::set_tick_end(task_function function, void * param) {
+	tick_end = function;
+	tick_end_param = param;
+}
+
+void RateScheduler::start() {
+	tick_timer->StartPeriodic(1.0 / base_rate);
+}
+
+void RateScheduler::stop() {
+	tick_timer->Stop();
+}
+
+void RateScheduler::lock() {
+	semTake(task_lock, WAIT_FOREVER);
+}
+
+void RateScheduler::unlock() {
+	semGive(task_lock);
+}
+
+void RateScheduler::tick(void * scheduler) {
+	RateScheduler * self = (RateScheduler *)scheduler;
+	self->tick_count++;
+	if (semTake(self->task_lock, NO_WAIT) != OK) {
+		self->busy_ticks++; //a periodic function has it; don't hold up the other Notifiers
+		return;
+	}
+	self->run_due();
+	if (self->tick_end != NULL) {
+		self->tick_end(self->tick_end_param);
+	}
+	self->unlock();
+}
+
+void RateScheduler::run_due() {
+	UINT32 tick_start = GetFPGATime();
+	bool ran_one = false;
+	for (int i = 0; i < num_tasks; i++) {
+		task &t = tasks[i];
+		if (!(active & task_bits[i]) || (INT32)(tick_count - t.next_tick) < 0) {
+			continue;
+		}
+		if (!ran_one && tick_begin != NULL) {
+			tick_begin(tick_begin_param); //the first due task always runs, so this is once a tick
+		}
+		UINT32 start = GetFPGATime();
+		if (ran_one && start - tick_start > budget_us) {
+			t.deferred++; //still due, so it goes first in its priority next tick
+			continue;
+		}
+		t.function(t.param);
+		UINT32 elapsed = GetFPGATime() - start;
+		ran_one = true;
+		t.runs++;
+		t.total_us += elapsed;
+		if (elapsed > t.max_us) {
+			t.max_us = elapsed;
+		}
+		t.next_tick += t.period_ticks;
+		if ((INT32)(tick_count - t.next_tick) >= 0) {
+			UINT32 behind = (tick_count - t.next_tick) / t.period_ticks + 1;
+			t.skipped += behind;
+			t.next_tick += behind * t.period_ticks;
+		}
+	}
+}
+
+void RateScheduler::dump() {
+	lock();
+	printf("scheduler, ticking at %.0f Hz, %u busy ticks\n", base_rate, busy_ticks);
+	busy_ticks = 0;
+	printf("  %-12s %6s %8s %8s %8s %9s %9s\n", "task", "Hz", "runs", "deferred", "skipped", "mean us", "max us");
+	for (int i = 0; i < num_tasks; i++) {
+		task &t = tasks[i];
+		if (t.runs == 0 && t.deferred == 0) {
+			continue;
+		}
+		printf("  %-12s %6.1f %8u %8u %8u %9.1f %9u\n", t.name, base_rate / t.period_ticks, t.runs,
+				t.deferred, t.skipped, t.runs ? (double)t.total_us / t.runs : 0.0, t.max_us);
+		t.runs = 0;
+		t.deferred = 0;
+		t.skipped = 0;
+		t.total_us = 0;
+		t.max_us = 0;
+	}
+	unlock();
+}
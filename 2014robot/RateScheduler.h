@@ -0,0 +1,100 @@
+#ifndef RATESCHEDULER_H_
+#define RATESCHEDULER_H_
+
+#include "WPILib.h"
+#include <semLib.h>
+#include "StaticArena.h"
+
+/*
+ * Runs subsystem updates from one Notifier, each at its own rate instead of once per
+ * driver station packet
+ * Subsystems register a function, a rate and a priority with add(), which hands back a
+ * bit for the task; each mode's Init then says which tasks run with set_active().
+ * The Notifier ticks at the base rate. Each tick runs the active tasks that are due, in
+ * priority order (lower numbers first, like vxWorks task priorities), each to completion.
+ * Rates are rounded to a whole number of ticks.
+ * Once a tick has used up its budget, the rest of the due tasks wait for the next tick
+ * (the first due task always runs), so slow low-priority work can't hold up the
+ * high-rate control. A task that falls a whole period behind skips ahead rather than
+ * running several times in a row to catch up.
+ * Tasks and the periodic functions share subsystem state, so the periodic functions
+ * must hold lock() while they touch it (and only then; keep it short); a tick holds it
+ * while its tasks run. A tick never waits for the lock: every Notifier in WPILib runs
+ * from one handler task, so blocking here would stall the arm controller and the ranging
+ * pings too. A tick that finds the lock held runs nothing and counts as busy; its due
+ * tasks run on the next tick that gets the lock.
+ */
+class RateScheduler {
+public:
+	static const double DEFAULT_BASE_RATE = 200.0; //Hz
+	static const double TICK_BUDGET = 0.5; //fraction of a tick the tasks may use
+	static const int MAX_TASKS = 16;
+
+	typedef void (*task_function)(void * param);
+	typedef UINT32 task_set; //one bit per task
+
+	//its Notifier goes in arena (or the heap, without one)
+	RateScheduler(double base_rate = DEFAULT_BASE_RATE, StaticArena * arena = NULL);
+	/*
+	 * Registers a task to run rate times a second (at most the base rate)
+	 * Returns its bit, or 0 if there's no room. Tasks start out inactive.
+	 * Name should be a string literal. Call before start().
+	 */
+	task_set add(const char * name, task_function function, void * param, double rate, int priority);
+	/*
+	 * Runs exactly these tasks from now on; ones that just became active run on the next tick
+	 * Doesn't lock, so it can be called with or without lock() held
+	 */
+	void set_active(task_set tasks);
+	task_set get_active() { return active; }
+	//runs before the first task on every tick that has one due, under the lock (eg to latch
+	//their inputs)
+	void set_tick_begin(task_function function, void * param);
+	//runs after the tasks on every tick, still under the lock (eg to commit their outputs)
+	void set_tick_end(task_function function, void * param);
+	void start();
+	void stop();
+	//for the periodic functions (not for tasks, which already run under it)
+	void lock();
+	void unlock();
+	/*
+	 * Prints each task's runs, deferrals, skips and times, and the busy ticks, since the
+	 * last dump, then clears them
+	 */
+	void dump();
+private:
+	typedef struct {
+		const char * name;
+		task_function function;
+		void * param;
+		int priority;
+		UINT32 period_ticks;
+		UINT32 next_tick;
+		//since the last dump
+		UINT32 runs;
+		UINT32 deferred; //due, but the tick's budget was already used
+		UINT32 skipped;  //periods lost to falling behind
+		UINT32 total_us;
+		UINT32 max_us;
+	} task;
+
+	Notifier * tick_timer;
+	SEM_ID task_lock;
+	double base_rate;
+	UINT32 budget_us;
+	task tasks[MAX_TASKS]; //sorted by priority
+	task_set task_bits[MAX_TASKS]; //the bit add() gave each, in the same order
+	int num_tasks;
+	volatile task_set active;
+	volatile UINT32 tick_count; //counts every tick, busy or not, so rates stay in real time
+	UINT32 busy_ticks; //since the last dump
+	task_function tick_begin;
+	void * tick_begin_param;
+	task_function tick_end;
+	void * tick_end_param;
+
+	static void tick(void * scheduler);
+	void run_due();
+};
+
+#endif
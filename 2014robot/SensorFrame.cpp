@@ -0,0 +1,83 @@
+#include "SensorFrame.h"
+#include <string.h>
+
+SensorFrame::SensorFrame() {
+	num_inputs = 0;
+	num_encoders = 0;
+	num_rangefinders = 0;
+	memset(calibrations, 0, sizeof(calibrations));
+	memset(&frame, 0, sizeof(frame));
+	latches = 0;
+}
+
+int SensorFrame::add(DigitalInput * input) {
+	for (int i = 0; i < num_inputs; i++) {
+		if (inputs[i] == input) {
+			return i;
+		}
+	}
+	if (input == NULL || num_inputs >= MAX_DIGITAL_INPUTS) {
+		return -1;
+	}
+	inputs[num_inputs] = input;
+	if (input->Get()) {
+		frame.digital |= 1 << num_inputs; //so it reads right before the first latch
+	}
+	return num_inputs++;
+}
+
+int SensorFrame::add(Encoder * encoder) {
+	for (int i = 0; i < num_encoders; i++) {
+		if (encoders[i] == encoder) {
+			return i;
+		}
+	}
+	if (encoder == NULL || num_encoders >= MAX_ENCODERS) {
+		return -1;
+	}
+	encoders[num_encoders] = encoder;
+	frame.counts[num_encoders] = encoder->Get();
+	frame.rates[num_encoders] = encoder->GetRate();
+	return num_encoders++;
+}
+
+int SensorFrame::add(Encoder * encoder, ArmCalibration * calibration) {
+	int n = add(encoder);
+	if (n >= 0) {
+		calibrations[n] = calibration;
+		frame.offsets[n] = calibration ? calibration->get_offset() : 0;
+	}
+	return n;
+}
+
+int SensorFrame::add(Rangefinder * rangefinder) {
+	for (int i = 0; i < num_rangefinders; i++) {
+		if (rangefinders[i] == rangefinder) {
+			return i;
+		}
+	}
+	if (rangefinder == NULL || num_rangefinders >= MAX_RANGEFINDERS) {
+		return -1;
+	}
+	rangefinders[num_rangefinders] = rangefinder;
+	frame.ranges[num_rangefinders] = rangefinder->Get();
+	return num_rangefinders++;
+}
+
+void SensorFrame::latch() {
+	UINT32 digital = 0;
+	for (int i = 0; i < num_inputs; i++) {
+		digital |= (inputs[i]->Get() ? 1 : 0) << i;
+	}
+	frame.digital = digital;
+	for (int i = 0; i < num_encoders; i++) {
+		frame.offsets[i] = calibrations[i] ? calibrations[i]->get_offset() : 0;
+		frame.counts[i] = encoders[i]->Get();
+		frame.rates[i] = encoders[i]->GetRate();
+	}
+	for (int i = 0; i < num_rangefinders; i++) {
+		frame.ranges[i] = rangefinders[i]->Get();
+	}
+	frame.timestamp = GetFPGATime();
+	latches++;
+}
@@ -0,0 +1,68 @@
+#ifndef SENSORFRAME_H_
+#define SENSORFRAME_H_
+
+#include "WPILib.h"
+#include "Rangefinder.h"
+#include "ArmCalibration.h"
+
+/*
+ * A cycle's sensor readings, read from the hardware once at the top of the cycle
+ * Register each sensor once with add(), which returns its number. latch() then reads every
+ * digital input into one bitmask, and every encoder (count and rate) and rangefinder into
+ * a snapshot; the getters only look at the snapshot. So however many times a cycle asks
+ * whether the ball is captured, the FPGA is read once, and every decision in the cycle
+ * sees the same value.
+ * An encoder zeroed by an ArmCalibration has its offset latched along with its count, so
+ * a re-zero from a switch interrupt mid-cycle doesn't show until the next latch.
+ * Whoever owns the frame latches it at the start of each cycle, like the OutputFrame is
+ * committed at the end. Not thread safe: the latcher and the readers need to share a lock
+ * (the robot uses the RateScheduler's).
+ * Interrupt handlers and the ArmController's loop read their sensors directly; they run
+ * between cycles and need what the switch or encoder says now.
+ */
+class SensorFrame {
+public:
+	static const int MAX_DIGITAL_INPUTS = 16;
+	static const int MAX_ENCODERS = 4;
+	static const int MAX_RANGEFINDERS = 2;
+
+	typedef struct {
+		UINT32 digital; //bit n is digital input n, as Get() read it
+		INT32 counts[MAX_ENCODERS];
+		INT32 offsets[MAX_ENCODERS]; //the calibration's offset when the count was read, or 0
+		double rates[MAX_ENCODERS];
+		float ranges[MAX_RANGEFINDERS]; //inches
+		UINT32 timestamp; //FPGA time of the latch, in microseconds
+	} snapshot;
+
+	SensorFrame();
+	//each returns the sensor's number for the getters, or -1 if it's null or there's no room
+	//a sensor that's already been added gets its old number back, so it's still read once
+	int add(DigitalInput * input);
+	int add(Encoder * encoder);
+	//as add(encoder), and get_position() subtracts calibration's offset as of the latch
+	int add(Encoder * encoder, ArmCalibration * calibration);
+	int add(Rangefinder * rangefinder);
+	//reads every sensor
+	void latch();
+	inline bool get(int input) { return (frame.digital >> input) & 1; }
+	inline INT32 get_count(int encoder) { return frame.counts[encoder]; }
+	//the count less its calibration's offset, both as of the latch
+	inline INT32 get_position(int encoder) { return frame.counts[encoder] - frame.offsets[encoder]; }
+	inline double get_rate(int encoder) { return frame.rates[encoder]; }
+	inline float get_range(int rangefinder) { return frame.ranges[rangefinder]; }
+	const snapshot & get_snapshot() { return frame; }
+	UINT32 get_latches() { return latches; }
+private:
+	DigitalInput * inputs[MAX_DIGITAL_INPUTS];
+	Encoder * encoders[MAX_ENCODERS];
+	ArmCalibration * calibrations[MAX_ENCODERS];
+	Rangefinder * rangefinders[MAX_RANGEFINDERS];
+	int num_inputs;
+	int num_encoders;
+	int num_rangefinders;
+	snapshot frame;
+	UINT32 latches;
+};
+
+#endif
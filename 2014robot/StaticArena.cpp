@@ -0,0 +1,65 @@
+#include "StaticArena.h"
+#include <stdio.h>
+
+StaticArena::StaticArena(const char * arena_name, void * block, size_t block_size) {
+	name = arena_name;
+	memory = (UINT8 *)block;
+	size = block_size;
+	used = 0;
+	objects = 0;
+	overflows = 0;
+	overflow_bytes = 0;
+	num_groups = 0;
+}
+
+void * StaticArena::allocate(size_t bytes) {
+	size_t start = (used + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	if (start + bytes > size) {
+		overflows++;
+		overflow_bytes += bytes;
+		return ::operator new(bytes);
+	}
+	used = start + bytes;
+	objects++;
+	if (num_groups > 0) {
+		groups[num_groups - 1].objects++;
+	}
+	return memory + start;
+}
+
+void StaticArena::begin_group(const char * group_name) {
+	if (num_groups >= MAX_GROUPS) {
+		return; //carries on in the last group
+	}
+	size_t start = (used + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+	used = start < size ? start : size;
+	groups[num_groups].name = group_name;
+	groups[num_groups].start = used;
+	groups[num_groups].objects = 0;
+	num_groups++;
+}
+
+void StaticArena::report() {
+	printf("%s: %u of %u bytes in %u objects\n", name, (unsigned)used, (unsigned)size, objects);
+	for (int i = 0; i < num_groups; i++) {
+		size_t end = i + 1 < num_groups ? groups[i + 1].start : used;
+		printf("  %-12s %7u bytes %4u objects\n", groups[i].name, (unsigned)(end - groups[i].start),
+				groups[i].objects);
+	}
+	if (overflows > 0) {
+		printf("  didn't fit: %u objects (%u bytes) went to the heap\n", overflows, (unsigned)overflow_bytes);
+	}
+}
+
+void * operator new(size_t size, StaticArena * arena) {
+	if (arena == NULL) {
+		return ::operator new(size);
+	}
+	return arena->allocate(size);
+}
+
+void operator delete(void * p, StaticArena * arena) {
+	if (arena == NULL) {
+		::operator delete(p);
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef STATICARENA_H_
+#define STATICARENA_H_
+
+#include "WPILib.h"
+#include <stddef.h>
+
+/*
+ * Hands out memory from one fixed block, for objects that live as long as the robot
+ * Construct into it with new (arena) Thing(...); nothing is ever freed. Keeping the
+ * robot's objects together in a statically sized block means the same addresses every
+ * boot and no scattering across the heap, and lets us say exactly how much memory the
+ * control state takes.
+ * begin_group() starts a new group on a cache line boundary: put the things one task
+ * touches together in a group and they share cache lines with each other, not with
+ * something else. report() prints each group's size.
+ * If the block runs out, allocations fall back to the heap (and report() says how many),
+ * so a size that was right for the sim's WPILib but not the real one still boots.
+ * new (NULL) Thing(...) just uses the heap, for code that isn't given an arena.
+ * Not thread safe; it's meant for RobotInit.
+ */
+class StaticArena {
+public:
+	static const size_t CACHE_LINE = 32; //bytes, on the cRIO's PowerPC
+	static const size_t ALIGNMENT = 8; //enough for a double
+	static const int MAX_GROUPS = 16;
+
+	//name should be a string literal; memory should be aligned to CACHE_LINE
+	StaticArena(const char * name, void * memory, size_t size);
+	void * allocate(size_t size);
+	//name should be a string literal
+	void begin_group(const char * name);
+	size_t get_used() { return used; }
+	size_t get_size() { return size; }
+	UINT32 get_objects() { return objects; }
+	//allocations that didn't fit and went to the heap
+	UINT32 get_overflows() { return overflows; }
+	void report();
+private:
+	typedef struct {
+		const char * name;
+		size_t start;
+		UINT32 objects;
+	} group;
+
+	const char * name;
+	UINT8 * memory;
+	size_t size;
+	size_t used;
+	UINT32 objects;
+	UINT32 overflows;
+	size_t overflow_bytes;
+	group groups[MAX_GROUPS];
+	int num_groups;
+};
+
+void * operator new(size_t size, StaticArena * arena);
+//only called if a constructor throws; the memory isn't given back
+void operator delete(void * p, StaticArena * arena);
+
+#endif
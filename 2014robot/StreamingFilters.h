@@ -0,0 +1,204 @@
+#ifndef STREAMINGFILTERS_H_
+#define STREAMINGFILTERS_H_
+
+/*
+ * Small streaming filters for sensor readings, sized at compile time
+ * Every filter has the same interface:
+ *     bool update(float in, float &out)
+ * which takes one sample, writes the filtered value to out, and returns false if the
+ * sample was rejected (out is untouched then). Filters that never reject always return true.
+ * Each update is O(1): the window sizes are template parameters, so the loops unroll
+ * and the ring indexes are masks instead of compares.
+ * Chain them with FilterChain to build a pipeline, eg
+ *     FilterChain<RangeGate<1, 200>, FilterChain<MovingMedian<3>, MovingAverage<4> > >
+ * None of these allocate; they're meant to be plain members.
+ */
+
+//compile-time check; fails to compile (negative array size) if the condition is false
+template <bool condition> struct FilterStaticAssert { typedef char check[condition ? 1 : -1]; };
+
+inline float filter_min(float a, float b) { return a < b ? a : b; }
+inline float filter_max(float a, float b) { return a > b ? a : b; }
+
+/*
+ * Mean of the last N samples, from a running sum
+ * N must be a power of two. Until N samples have arrived it averages only the ones it has,
+ * so it doesn't pull the first readings toward zero.
+ */
+template <int N>
+class MovingAverage {
+public:
+	MovingAverage() { reset(); }
+	void reset() {
+		for (int i = 0; i < N; i++) {
+			window[i] = 0.0f;
+		}
+		sum = 0.0;
+		index = 0;
+		count = 0;
+	}
+	bool update(float in, float &out) {
+		sum += in - window[index];
+		window[index] = in;
+		index = (index + 1) & (N - 1);
+		count += count < N;
+		out = (float)(sum / count);
+		return true;
+	}
+private:
+	typedef typename FilterStaticAssert<((N & (N - 1)) == 0 && N > 0)>::check window_must_be_power_of_two;
+	float window[N];
+	double sum; //double so the add/subtract rounding doesn't drift over a match
+	int index;
+	int count;
+};
+
+/*
+ * Exponential moving average, out += (in - out) * NUM / DEN
+ * The weight is a ratio of integers because C++ doesn't allow float template parameters.
+ * The first sample is passed straight through instead of being blended with zero.
+ */
+template <int NUM, int DEN>
+class ExponentialAverage {
+public:
+	ExponentialAverage() { reset(); }
+	void reset() {
+		value = 0.0f;
+		primed = false;
+	}
+	bool update(float in, float &out) {
+		value = primed ? value + (in - value) * ((float)NUM / DEN) : in;
+		primed = true;
+		out = value;
+		return true;
+	}
+private:
+	typedef typename FilterStaticAssert<(NUM > 0 && NUM <= DEN)>::check weight_must_be_between_0_and_1;
+	float value;
+	bool primed;
+};
+
+/*
+ * Median of the last N samples, for knocking out single bad readings
+ * N = 3 and N = 5 are fixed min/max selection networks with no data-dependent branches;
+ * other sizes fall back to a small insertion sort of the window.
+ */
+template <int N>
+class MovingMedian {
+public:
+	MovingMedian() { reset(); }
+	void reset() {
+		index = 0;
+		count = 0;
+	}
+	bool update(float in, float &out) {
+		if (count == 0) {
+			for (int i = 0; i < N; i++) {
+				window[i] = in; //so the window starts out full of real readings
+			}
+		}
+		window[index] = in;
+		index = index + 1 == N ? 0 : index + 1;
+		count += count < N;
+		out = median();
+		return true;
+	}
+private:
+	float window[N];
+	int index;
+	int count;
+
+	float median() {
+		float sorted[N];
+		for (int i = 0; i < N; i++) {
+			float x = window[i];
+			int j = i;
+			for (; j > 0 && sorted[j - 1] > x; j--) {
+				sorted[j] = sorted[j - 1];
+			}
+			sorted[j] = x;
+		}
+		return sorted[N / 2];
+	}
+};
+
+template <>
+inline float MovingMedian<3>::median() {
+	float a = window[0], b = window[1], c = window[2];
+	return filter_max(filter_min(a, b), filter_min(filter_max(a, b), c));
+}
+
+template <>
+inline float MovingMedian<5>::median() {
+	//Devillard's 7-exchange median of 5; each exchange is a min and a max
+	float p0 = window[0], p1 = window[1], p2 = window[2], p3 = window[3], p4 = window[4], t;
+	t = filter_min(p0, p1); p1 = filter_max(p0, p1); p0 = t;
+	t = filter_min(p3, p4); p4 = filter_max(p3, p4); p3 = t;
+	p3 = filter_max(p0, p3);
+	p1 = filter_min(p1, p4);
+	t = filter_min(p1, p2); p2 = filter_max(p1, p2); p1 = t;
+	p2 = filter_min(p2, p3);
+	return filter_max(p1, p2);
+}
+
+/*
+ * Rejects readings outside [MIN, MAX] (in whatever units the sensor uses)
+ */
+template <int MIN, int MAX>
+class RangeGate {
+public:
+	void reset() {}
+	bool update(float in, float &out) {
+		bool accept = (in >= MIN) & (in <= MAX);
+		out = in;
+		return accept;
+	}
+};
+
+/*
+ * Rejects readings that jump more than MAX_STEP away from the last accepted one
+ * After MAX_REJECTS rejections in a row it gives up on the old value and accepts the
+ * new one, so a real change (something walked in front of the sensor) gets through.
+ */
+template <int MAX_STEP, int MAX_REJECTS>
+class OutlierGate {
+public:
+	OutlierGate() { reset(); }
+	void reset() {
+		last = 0.0f;
+		rejects = MAX_REJECTS; //accept whatever comes first
+	}
+	bool update(float in, float &out) {
+		float step = in - last;
+		bool accept = ((step <= MAX_STEP) & (step >= -MAX_STEP)) | (rejects >= MAX_REJECTS);
+		rejects = accept ? 0 : rejects + 1;
+		last = accept ? in : last;
+		out = in;
+		return accept;
+	}
+private:
+	float last;
+	int rejects;
+};
+
+/*
+ * Runs FIRST, then feeds its output to SECOND
+ * A sample rejected by FIRST never reaches SECOND.
+ */
+template <class FIRST, class SECOND>
+class FilterChain {
+public:
+	void reset() {
+		first.reset();
+		second.reset();
+	}
+	bool update(float in, float &out) {
+		float middle;
+		return first.update(in, middle) && second.update(middle, out);
+	}
+private:
+	FIRST first;
+	SECOND second;
+};
+
+#endif
@@ -0,0 +1,212 @@
+#include "TelemetryFormat.h"
+#include <string.h>
+
+namespace TelemetryFormat {
+
+//channels stored as flipped bits rather than differences
+static const UINT32 BITFIELD_CHANNELS = (1 << PILOT_BUTTONS) | (1 << COPILOT_BUTTONS)
+		| (1 << SWITCHES) | (1 << SOLENOIDS) | (1 << LED);
+
+static inline UINT32 zigzag(INT32 v) {
+	return ((UINT32)v << 1) ^ (UINT32)(v >> 31);
+}
+
+static inline INT32 unzigzag(UINT32 v) {
+	return (INT32)(v >> 1) ^ -(INT32)(v & 1);
+}
+
+static inline int put_varint(UINT8 * out, UINT32 v) {
+	int n = 0;
+	while (v >= 0x80) {
+		out[n++] = (UINT8)(v | 0x80);
+		v >>= 7;
+	}
+	out[n++] = (UINT8)v;
+	return n;
+}
+
+//0 if the varint runs past end
+static inline int get_varint(const UINT8 * in, const UINT8 * end, UINT32 &v) {
+	v = 0;
+	for (int n = 0; n < 5 && in + n < end; n++) {
+		v |= (UINT32)(in[n] & 0x7F) << (7 * n);
+		if (!(in[n] & 0x80)) {
+			return n + 1;
+		}
+	}
+	return 0;
+}
+
+static inline void put_big_endian(UINT8 * out, UINT32 v) {
+	out[0] = (UINT8)(v >> 24);
+	out[1] = (UINT8)(v >> 16);
+	out[2] = (UINT8)(v >> 8);
+	out[3] = (UINT8)v;
+}
+
+static inline UINT32 get_big_endian(const UINT8 * in) {
+	return (UINT32)in[0] << 24 | (UINT32)in[1] << 16 | (UINT32)in[2] << 8 | in[3];
+}
+
+void to_channels(const record &r, INT32 * v) {
+	v[TIMESTAMP] = (INT32)(r.timestamp / TIME_UNIT);
+	v[FRONT_LEFT] = r.outputs[0];
+	v[FRONT_RIGHT] = r.outputs[1];
+	v[REAR_LEFT] = r.outputs[2];
+	v[REAR_RIGHT] = r.outputs[3];
+	v[ROLLER] = r.outputs[4];
+	v[ARM_LIFT] = r.outputs[5];
+	v[WINCH] = r.outputs[6];
+	for (int i = 0; i < 4; i++) {
+		v[PILOT_AXIS_1 + i] = r.pilot_axes[i];
+		v[COPILOT_AXIS_1 + i] = r.copilot_axes[i];
+	}
+	v[ARM_ENCODER] = r.arm_encoder;
+	v[WINCH_ENCODER] = r.winch_encoder;
+	v[RANGE] = (INT32)(r.range * 10.0f + (r.range < 0.0f ? -0.5f : 0.5f));
+	v[PILOT_BUTTONS] = r.pilot_buttons;
+	v[COPILOT_BUTTONS] = r.copilot_buttons;
+	v[SWITCHES] = r.switches;
+	v[SOLENOIDS] = r.solenoids;
+	v[LED] = r.led;
+	v[MODE] = r.mode;
+}
+
+void from_channels(const INT32 * v, record &r) {
+	r.timestamp = (UINT32)v[TIMESTAMP] * TIME_UNIT;
+	r.outputs[0] = v[FRONT_LEFT];
+	r.outputs[1] = v[FRONT_RIGHT];
+	r.outputs[2] = v[REAR_LEFT];
+	r.outputs[3] = v[REAR_RIGHT];
+	r.outputs[4] = v[ROLLER];
+	r.outputs[5] = v[ARM_LIFT];
+	r.outputs[6] = v[WINCH];
+	for (int i = 0; i < 4; i++) {
+		r.pilot_axes[i] = v[PILOT_AXIS_1 + i];
+		r.copilot_axes[i] = v[COPILOT_AXIS_1 + i];
+	}
+	r.arm_encoder = v[ARM_ENCODER];
+	r.winch_encoder = v[WINCH_ENCODER];
+	r.range = v[RANGE] / 10.0f;
+	r.pilot_buttons = v[PILOT_BUTTONS];
+	r.copilot_buttons = v[COPILOT_BUTTONS];
+	r.switches = v[SWITCHES];
+	r.solenoids = v[SOLENOIDS];
+	r.led = v[LED];
+	r.mode = v[MODE];
+}
+
+RecordEncoder::RecordEncoder() {
+	memset(previous, 0, sizeof(previous));
+	previous_step = 0;
+	count = 0;
+}
+
+int RecordEncoder::encode(const record &r, UINT8 * out, bool &key) {
+	INT32 v[NUM_CHANNELS];
+	to_channels(r, v);
+	int n = 0;
+	key = count % INDEX_INTERVAL == 0;
+	if (key) {
+		for (int c = 0; c < NUM_CHANNELS; c++) {
+			n += put_varint(out + n, c == TIMESTAMP ? (UINT32)v[c] : zigzag(v[c]));
+		}
+		previous_step = 0;
+	} else {
+		UINT32 changes[NUM_CHANNELS];
+		UINT32 mask = 0;
+		for (int c = 0; c < NUM_CHANNELS; c++) {
+			if (c == TIMESTAMP) {
+				INT32 step = v[c] - previous[c];
+				changes[c] = zigzag(step - previous_step);
+				previous_step = step;
+			} else if ((BITFIELD_CHANNELS >> c) & 1) {
+				changes[c] = v[c] ^ previous[c];
+			} else {
+				changes[c] = zigzag(v[c] - previous[c]);
+			}
+			mask |= (UINT32)(changes[c] != 0) << c;
+		}
+		n += put_varint(out, mask);
+		for (UINT32 m = mask; m != 0; m &= m - 1) {
+			n += put_varint(out + n, changes[__builtin_ctz(m)]);
+		}
+	}
+	memcpy(previous, v, sizeof(previous));
+	count++;
+	return n;
+}
+
+RecordDecoder::RecordDecoder() {
+	memset(previous, 0, sizeof(previous));
+	previous_step = 0;
+	count = 0;
+}
+
+int RecordDecoder::decode(const UINT8 * in, const UINT8 * end, record &r) {
+	INT32 v[NUM_CHANNELS];
+	UINT32 x;
+	int n = 0;
+	int used;
+	if (count % INDEX_INTERVAL == 0) {
+		for (int c = 0; c < NUM_CHANNELS; c++) {
+			if (!(used = get_varint(in + n, end, x))) {
+				return 0;
+			}
+			n += used;
+			v[c] = c == TIMESTAMP ? (INT32)x : unzigzag(x);
+		}
+		previous_step = 0;
+	} else {
+		UINT32 mask;
+		if (!(used = get_varint(in, end, mask))) {
+			return 0;
+		}
+		n += used;
+		for (int c = 0; c < NUM_CHANNELS; c++) {
+			x = 0;
+			if ((mask >> c) & 1) {
+				if (!(used = get_varint(in + n, end, x))) {
+					return 0;
+				}
+				n += used;
+			}
+			if (c == TIMESTAMP) {
+				previous_step += unzigzag(x);
+				v[c] = previous[c] + previous_step;
+			} else if ((BITFIELD_CHANNELS >> c) & 1) {
+				v[c] = previous[c] ^ x;
+			} else {
+				v[c] = previous[c] + unzigzag(x);
+			}
+		}
+	}
+	from_channels(v, r);
+	memcpy(previous, v, sizeof(previous));
+	count++;
+	return n;
+}
+
+void make_header(log_header &header) {
+	memcpy(header.magic, "T83C", 4);
+	header.version = VERSION;
+	header.num_channels = NUM_CHANNELS;
+	UINT8 * interval = (UINT8 *)&header.index_interval;
+	interval[0] = (UINT8)(INDEX_INTERVAL >> 8);
+	interval[1] = (UINT8)INDEX_INTERVAL;
+	put_big_endian((UINT8 *)&header.time_unit, TIME_UNIT);
+}
+
+void make_index_entry(index_entry &entry, UINT32 time, UINT32 offset, UINT32 record_number) {
+	put_big_endian((UINT8 *)&entry.time, time);
+	put_big_endian((UINT8 *)&entry.offset, offset);
+	put_big_endian((UINT8 *)&entry.record_number, record_number);
+}
+
+void read_index_entry(const index_entry &entry, UINT32 &time, UINT32 &offset, UINT32 &record_number) {
+	time = get_big_endian((const UINT8 *)&entry.time);
+	offset = get_big_endian((const UINT8 *)&entry.offset);
+	record_number = get_big_endian((const UINT8 *)&entry.record_number);
+}
+
+}
@@ -0,0 +1,113 @@
+#ifndef TELEMETRYFORMAT_H_
+#define TELEMETRYFORMAT_H_
+
+#include "WPILib.h"
+
+/*
+ * The compressed telemetry log format
+ * A record is split into channels (one per number in it). Every INDEX_INTERVAL records
+ * there's a key record with every channel's full value; the ones after it only store
+ * what changed since the record before:
+ *   varint: bitmask of the channels that changed (bit n is channel n)
+ *   then for each changed channel, lowest first, a varint:
+ *     the timestamp: how much the time step changed (zigzag), so a steady loop costs nothing
+ *     bitfields (buttons, switches, solenoids): the bits that flipped
+ *     everything else: the difference (zigzag)
+ * Channels are numbered with the ones that change most often first, so the mask is usually
+ * one or two bytes. Varints are 7 bits per byte, low bits first, top bit set if more follow,
+ * so the log reads the same on any machine.
+ * Each key record also gets an entry in a separate index file: its time, its byte offset
+ * in the log and its record number. The entries are fixed size, so a tool can map the
+ * index, binary search it for a time and start decoding at that key record.
+ * Times are stored in TIME_UNIT microsecond steps.
+ */
+namespace TelemetryFormat {
+
+//one cycle of the robot, as TelemetryRecorder takes it
+typedef struct {
+	UINT32 timestamp;      //FPGA time, microseconds
+	INT32 arm_encoder;     //ticks
+	INT32 winch_encoder;   //ticks
+	float range;           //inches
+	UINT16 pilot_buttons;  //bit (n - 1) is button n
+	UINT16 copilot_buttons;
+	UINT16 switches;       //bits, see AerialAssistRobot::fill_telemetry()
+	INT8 pilot_axes[4];    //axes 1-4, -127 to 127
+	INT8 copilot_axes[4];
+	INT8 outputs[7];       //speed controller outputs, -127 to 127
+	UINT8 solenoids;       //bits
+	UINT8 led;             //DigitalLED color
+	UINT8 mode;            //LoopProfiler mode
+} record;
+
+static const int INDEX_INTERVAL = 50; //records between key records, 1 second at 50 Hz
+static const UINT32 TIME_UNIT = 100; //microseconds
+static const UINT32 VERSION = 2;
+static const int MAX_ENCODED_SIZE = 5 * 33; //a mask and every channel, at the biggest a varint gets
+
+typedef enum {
+	TIMESTAMP,
+	FRONT_LEFT, FRONT_RIGHT, REAR_LEFT, REAR_RIGHT,
+	PILOT_AXIS_1, PILOT_AXIS_2, PILOT_AXIS_3, PILOT_AXIS_4,
+	ARM_ENCODER, WINCH_ENCODER, ARM_LIFT, ROLLER, WINCH,
+	RANGE, //tenths of an inch
+	COPILOT_AXIS_1, COPILOT_AXIS_2, COPILOT_AXIS_3, COPILOT_AXIS_4,
+	PILOT_BUTTONS, COPILOT_BUTTONS, SWITCHES, SOLENOIDS, LED, MODE,
+	NUM_CHANNELS
+} channel;
+
+typedef struct {
+	char magic[4];          //"T83C"
+	UINT8 version;
+	UINT8 num_channels;
+	UINT16 index_interval;
+	UINT32 time_unit;       //microseconds, big-endian like everything fixed size here
+} log_header;
+
+typedef struct {
+	UINT32 time;            //in TIME_UNITs
+	UINT32 offset;          //bytes from the start of the log
+	UINT32 record_number;
+} index_entry;              //big-endian
+
+class RecordEncoder {
+public:
+	RecordEncoder();
+	/*
+	 * Appends r to out, returns the number of bytes written (at most MAX_ENCODED_SIZE)
+	 * Sets key to whether this one was a key record, which needs an index entry
+	 */
+	int encode(const record &r, UINT8 * out, bool &key);
+private:
+	INT32 previous[NUM_CHANNELS];
+	INT32 previous_step;
+	UINT32 count;
+};
+
+class RecordDecoder {
+public:
+	RecordDecoder();
+	//start decoding at a key record, eg one found through the index
+	void seek_to_key(UINT32 record_number) { count = record_number; }
+	/*
+	 * Decodes the record at in into r, returns the bytes it took, or 0 if it ran past end
+	 * Times come back rounded to TIME_UNIT.
+	 */
+	int decode(const UINT8 * in, const UINT8 * end, record &r);
+private:
+	INT32 previous[NUM_CHANNELS];
+	INT32 previous_step;
+	UINT32 count;
+};
+
+//header and index entries in file byte order
+void make_header(log_header &header);
+void make_index_entry(index_entry &entry, UINT32 time, UINT32 offset, UINT32 record_number);
+void read_index_entry(const index_entry &entry, UINT32 &time, UINT32 &offset, UINT32 &record_number);
+
+void to_channels(const record &r, INT32 * values);
+void from_channels(const INT32 * values, record &r);
+
+}
+
+#endif
@@ -0,0 +1,149 @@
+#include "TelemetryRecorder.h"
+#include "MemoryBarrier.h"
+#include "sysLib.h"
+#include <stdlib.h>
+
+TelemetryRecorder * TelemetryRecorder::instance = NULL;
+bool TelemetryRecorder::discarding = false;
+
+TelemetryRecorder::TelemetryRecorder(const char * log_path, const char * index_path, StaticArena * arena) {
+	this->log_path = log_path;
+	this->index_path = index_path;
+	log_file = NULL;
+	index_file = NULL;
+	encoded_bytes = 0;
+	log_bytes = 0;
+	head = 0;
+	tail = 0;
+	dropped = 0;
+	written = 0;
+	wake = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
+	flush_lock = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE);
+	flush_task = new (arena) Task("telemetry", (FUNCPTR)TelemetryRecorder::flush_loop, FLUSH_TASK_PRIORITY);
+	instance = this;
+}
+
+bool TelemetryRecorder::start() {
+	if (discarding) {
+		return false;
+	}
+	rotate(log_path);
+	rotate(index_path);
+	log_file = fopen(log_path, "wb");
+	index_file = fopen(index_path, "wb");
+	if (log_file == NULL || index_file == NULL) {
+		printf("telemetry: couldn't open %s or %s\n", log_path, index_path);
+		return false;
+	}
+	TelemetryFormat::log_header header;
+	TelemetryFormat::make_header(header);
+	fwrite(&header, sizeof(header), 1, log_file);
+	log_bytes = sizeof(header);
+#ifndef __vxworks
+	atexit(TelemetryRecorder::flush_at_exit); //the simulator just exits at the end of a run
+#endif
+	return flush_task->Start();
+}
+
+void TelemetryRecorder::add(const record &r) {
+	UINT32 h = head;
+	UINT32 queued = h - tail;
+	if (queued >= (UINT32)RING_SIZE) {
+		dropped++;
+		return;
+	}
+	ring[h & RING_MASK] = r;
+	memory_barrier(); //the record has to be there before the flush task can see it
+	head = h + 1;
+	if (discarding) {
+		tail = h + 1; //there's no flush task to do it
+		return;
+	}
+	if (queued + 1 == RING_SIZE / 2) {
+		semGive(wake);
+	}
+}
+
+void TelemetryRecorder::request_flush() {
+	semGive(wake);
+}
+
+void TelemetryRecorder::flush() {
+	if (log_file == NULL) {
+		return;
+	}
+	semTake(flush_lock, WAIT_FOREVER);
+	UINT32 t = tail;
+	UINT32 h = head;
+	memory_barrier();
+	for (; t != h; t++) {
+		if (ENCODE_BUFFER_SIZE - encoded_bytes < TelemetryFormat::MAX_ENCODED_SIZE) {
+			write_encoded();
+		}
+		bool key;
+		int offset = log_bytes + encoded_bytes;
+		encoded_bytes += encoder.encode(ring[t & RING_MASK], encode_buffer + encoded_bytes, key);
+		if (key) {
+			TelemetryFormat::index_entry entry;
+			TelemetryFormat::make_index_entry(entry,
+					ring[t & RING_MASK].timestamp / TelemetryFormat::TIME_UNIT, offset, written + t - tail);
+			fwrite(&entry, sizeof(entry), 1, index_file);
+		}
+	}
+	memory_barrier(); //done reading those slots before add() can reuse them
+	written += t - tail;
+	tail = t;
+	write_encoded();
+	fflush(log_file);
+	fflush(index_file);
+	semGive(flush_lock);
+}
+
+//path.7 -> path.8, ... path -> path.1; the oldest is deleted, and missing ones are skipped
+void TelemetryRecorder::rotate(const char * path) {
+	char from[256];
+	char to[256];
+	for (int n = KEEP_BOOTS; n > 0; n--) {
+		if (n > 1) {
+			snprintf(from, sizeof(from), "%s.%d", path, n - 1);
+		} else {
+			snprintf(from, sizeof(from), "%s", path);
+		}
+		snprintf(to, sizeof(to), "%s.%d", path, n);
+		FILE * f = fopen(from, "rb");
+		if (f == NULL) {
+			continue;
+		}
+		fclose(f);
+		remove(to); //dosFs won't rename over an existing file
+		rename(from, to);
+	}
+}
+
+void TelemetryRecorder::write_encoded() {
+	fwrite(encode_buffer, 1, encoded_bytes, log_file);
+	log_bytes += encoded_bytes;
+	encoded_bytes = 0;
+}
+
+INT8 TelemetryRecorder::pack_output(float value) {
+	if (value > 1.0f) {
+		value = 1.0f;
+	} else if (value < -1.0f) {
+		value = -1.0f;
+	}
+	return (INT8)(value * 127.0f + (value < 0.0f ? -0.5f : 0.5f));
+}
+
+int TelemetryRecorder::flush_loop() {
+	int timeout = (int)(FLUSH_PERIOD * sysClkRateGet());
+	while (true) {
+		semTake(instance->wake, timeout);
+		instance->flush();
+	}
+	return 0;
+}
+
+void TelemetryRecorder::flush_at_exit() {
+	instance->flush();
+}
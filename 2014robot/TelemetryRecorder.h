@@ -0,0 +1,89 @@
+#ifndef TELEMETRYRECORDER_H_
+#define TELEMETRYRECORDER_H_
+
+#include "WPILib.h"
+#include "semLib.h"
+#include "TelemetryFormat.h"
+#include "StaticArena.h"
+#include <stdio.h>
+
+/*
+ * Records every cycle's inputs and outputs to a file, without the control loop
+ * ever touching the file
+ * add() copies one fixed-size record into a ring buffer and bumps a counter, nothing else.
+ * A low priority task wakes up every FLUSH_PERIOD seconds (or as soon as the ring is half
+ * full) and writes whatever has piled up. If the task falls a whole ring behind, new
+ * records are dropped and counted rather than blocking the loop.
+ * The flush task also does the compressing: the log is written in TelemetryFormat, with
+ * its seek index in a second file.
+ * Each boot gets fresh files: start() first moves the last boot's to .1 (and .1 to .2,
+ * and so on, up to KEEP_BOOTS), so a brownout or a power cycle between matches doesn't
+ * wipe out the match before it.
+ * One recorder per program: the flush task finds it through a static pointer.
+ */
+class TelemetryRecorder {
+public:
+	typedef TelemetryFormat::record record;
+
+	static const int RING_SIZE = 1024; //records; 20 seconds at 50 Hz
+	static const double FLUSH_PERIOD = 0.5; //seconds
+	static const INT32 FLUSH_TASK_PRIORITY = 200; //well below the robot's loop (101)
+	static const int KEEP_BOOTS = 8; //earlier boots' files kept, as .1 (the last boot) to .8
+
+	//its flush task's Task object goes in arena (or the heap, without one)
+	TelemetryRecorder(const char * log_path, const char * index_path, StaticArena * arena = NULL);
+	/*
+	 * From then on, start() opens no files and starts no flush task, and add() still copies
+	 * each record into the ring but then throws it away. For harnesses (sim/bench) that run
+	 * the robot but mustn't touch its files, or have disk writes going while they time it.
+	 */
+	static void set_discarding(bool discard) { discarding = discard; }
+	//moves the last boots' files along, opens new ones and starts the flush task; false if
+	//they couldn't be opened
+	bool start();
+	//copies r into the ring; call once per cycle from the control loop
+	void add(const record &r);
+	//wakes the flush task now rather than at its next period, eg when disabled
+	void request_flush();
+	//writes out everything in the ring; from the flush task, or anywhere but the control loop
+	void flush();
+	UINT32 get_dropped() { return dropped; }
+	UINT32 get_written() { return written; }
+	UINT32 get_bytes_written() { return log_bytes; }
+
+	//-127 to 127 for -1.0 to 1.0
+	static INT8 pack_output(float value);
+private:
+	static const UINT32 RING_MASK = RING_SIZE - 1;
+
+	static const int ENCODE_BUFFER_SIZE = 8192;
+
+	const char * log_path;
+	const char * index_path;
+	FILE * log_file;
+	FILE * index_file;
+	Task * flush_task;
+	SEM_ID wake;
+	SEM_ID flush_lock;
+
+	record ring[RING_SIZE];
+	volatile UINT32 head; //records added, ever; only add() writes it
+	volatile UINT32 tail; //records written out, ever; only flush() writes it
+	UINT32 dropped;
+	UINT32 written;
+
+	//the flush task's
+	TelemetryFormat::RecordEncoder encoder;
+	UINT8 encode_buffer[ENCODE_BUFFER_SIZE];
+	int encoded_bytes;
+	UINT32 log_bytes;
+	void write_encoded();
+	static void rotate(const char * path);
+
+	static TelemetryRecorder * instance;
+	static bool discarding;
+	static int flush_loop();
+	static void flush_at_exit();
+};
+
+#endif
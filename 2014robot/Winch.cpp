@@ -1,16 +1,34 @@
 #include "Winch.h"
 #include <cmath>
 
-Winch::Winch(Victor * motor, Solenoid * sol, Encoder * encoder, DigitalInput * max_pos) {
+Winch::Winch(Victor * motor, Solenoid * sol, Encoder * encoder, DigitalInput * max_pos,
+		SensorFrame * sensor_frame, OutputFrame * frame, StaticArena * arena) {
 	winch_motor = motor;
-	clutch = sol;
+	outputs = frame;
+	clutch = outputs->add(sol);
 	winch_encoder = encoder;
 	max_lim_switch = max_pos;
-	clutch_position = CLUTCH_OUT;
+	target_rotations = 0.0f;
+	target_pending = false;
+	
+	encoder_zeroed = winch_encoder != NULL;
+	if (encoder_zeroed){
+		winch_encoder->Reset();
+		winch_encoder->Start();
+	}
+	sensors = sensor_frame;
+	encoder_input = sensors->add(winch_encoder);
 	
 	mode = Winch::HOLDING;
-	timer = new Timer();
+	limit_stop = false;
+	max_lim_switch->RequestInterrupts(Winch::limit_switch_edge, this);
+	max_lim_switch->SetUpSourceEdge(true, true);
+	max_lim_switch->EnableInterrupts();
+	switch_closed = max_lim_switch->Get();
+	timer = new (arena) Timer();
 	timer->Start();
+	
+	shot_table.build(computeEncoderStepsFromDistance, SHOT_TABLE_MIN_DIST, SHOT_TABLE_MAX_DIST);
 }
 
 void Winch::update(bool safety_mode){
@@ -20,10 +38,17 @@ void Winch::update(bool safety_mode){
 	}
 	double time_s = timer->Get();
 	
+	if (limit_stop){
+		limit_stop = false;
+		if (pulling()){
+			mode = HOLDING; //the interrupt has already stopped the motor
+		}
+	}
+	
 	//sequence for firing
 	if (mode == FIRING){
 		if (time_s < 2.0){
-			clutch->Set(CLUTCH_OUT);
+			outputs->set(clutch, CLUTCH_OUT);
 		} else {
 			mode = POST_FIRING;
 			timer->Reset();
@@ -36,7 +61,12 @@ void Winch::update(bool safety_mode){
 		if (time_s < 1.0){
 			winch_motor->Set(-0.2);
 		} else {
-			mode = WINDING_BACK; //automatically wind back after firing
+			if (winch_encoder){
+				winch_encoder->Reset(); //the catapult is at rest with the clutch in; that's step 0
+			}
+			//automatically wind back after firing, to a target if one came in while we fired
+			mode = target_pending ? WINDING_TO_TARGET : WINDING_BACK;
+			target_pending = false;
 			timer->Reset();
 		}
 	}
@@ -44,14 +74,41 @@ void Winch::update(bool safety_mode){
 	//wind winch back
 	if (mode == WINDING_BACK){
 		if (!wound_back() && time_s < load_time){
-			winch_motor->Set(-0.7f);
+			pull(0.7f);
 		} else {
 			mode = HOLDING; //stop winding back if we've hit the switch
 		}
 	}
 	
+	//wind to an encoder target, slowing down so we stop on it rather than past it
+	if (mode == WINDING_TO_TARGET){
+		float remaining = target_rotations - encoder_steps();
+		if (wound_back() || time_s >= load_time){
+			mode = HOLDING; //can't go any further, or something's wrong with the encoder
+		} else if (remaining <= TARGET_TOLERANCE){
+			mode = HOLDING_TARGET;
+		} else {
+			pull(profiled_wind_power(remaining));
+		}
+	}
+	
+	//the springs pull rope back out, so push back in proportion to how far we've slipped
+	if (mode == HOLDING_TARGET){
+		if (wound_back()){
+			mode = HOLDING;
+		} else {
+			float power = HOLD_GAIN * (target_rotations - encoder_steps());
+			if (power < 0.0f){
+				power = 0.0f; //a little past the target is fine, don't unwind
+			} else if (power > MAX_HOLD_POWER){
+				power = MAX_HOLD_POWER;
+			}
+			pull(power);
+		}
+	}
+	
 	if (mode != FIRING) {
-		clutch->Set(CLUTCH_IN); //so we can push the clutch back in when we stop firing
+		outputs->set(clutch, CLUTCH_IN); //so we can push the clutch back in when we stop firing
 	}
 	
 	if (mode == HOLDING || mode == FIRING) {
@@ -65,6 +122,7 @@ void Winch::wind_back() {
 		timer->Reset();
 	}
 	mode = WINDING_BACK;
+	target_pending = false;
 }
 
 void Winch::fire(){
@@ -75,25 +133,90 @@ void Winch::fire(){
 }
 
 bool Winch::wound_back() {
-	return max_lim_switch->Get();
+	return switch_closed;
+}
+
+//modes that run the motor pulling the catapult down
+bool Winch::pulling() {
+	return mode == WINDING_BACK || mode == WINDING_TO_TARGET || mode == HOLDING_TARGET;
+}
+
+void Winch::pull(float power) {
+	winch_motor->Set(WIND_DIRECTION * power);
+	if (switch_closed){
+		winch_motor->Set(0.0f); //the switch closed after the caller checked it
+	}
+}
+
+void Winch::limit_switch_edge(UINT32 mask, void * winch) {
+	Winch * self = (Winch *)winch;
+	self->switch_closed = self->max_lim_switch->Get();
+	if (self->switch_closed && self->pulling()){
+		self->winch_motor->Set(0.0f);
+		self->limit_stop = true;
+	}
+}
+
+bool Winch::at_target() {
+	return mode == HOLDING_TARGET;
+}
+
+float Winch::encoder_steps(){
+	return sensors->get_count(encoder_input);
+}
+
+/*
+ * Power (0 to 1, winding direction) for the motor with remaining steps still to go
+ * The speed we want is the most we can shed at WIND_DECELERATION before the target
+ * (v^2 = 2ad), capped at what the motor can do. Power is feed-forward for that
+ * speed, plus a push in proportion to how far behind it we are.
+ */
+float Winch::profiled_wind_power(float remaining){
+	float wanted_rate = sqrtf(2.0f * WIND_DECELERATION * remaining);
+	if (wanted_rate > MAX_WIND_RATE){
+		wanted_rate = MAX_WIND_RATE;
+	}
+	float power = wanted_rate / MAX_WIND_RATE + WIND_RATE_GAIN * (wanted_rate - sensors->get_rate(encoder_input));
+	if (power < 0.0f){
+		return 0.0f; //the springs will slow it down for us
+	}
+	if (power > 1.0f){
+		return 1.0f;
+	}
+	return power;
 }
 
 void Winch::wind_back_dist(float dist){	
 	//winds back given a distance from the goal
-	float angle = computeAngleFromDistance(dist);
-	wind_back_rotations(computeEncoderStepsFromAngle(angle));
+	float steps;
+	if (lookup_encoder_steps(dist, steps)){
+		wind_back_rotations(steps);
+	} else if (mode != FIRING && mode != POST_FIRING){
+		wind_back(); //no answer from the model, so the full pull
+	}
+}
+
+bool Winch::lookup_encoder_steps(float dist, float &steps){
+	return shot_table.lookup(dist, steps);
 }
 
 void Winch::wind_back_rotations(float n_rotations){
-	//once this switch is engaged, that means we can start the encoder
-	winch_encoder->Start();
-	//only engage clutch when catapult is at rest
-	if (clutch_position == CLUTCH_OUT){
-		clutch->Set(CLUTCH_IN);
-		clutch_position = CLUTCH_IN;
+	if (!encoder_zeroed){
+		wind_back(); //no encoder, so the limit switch is the only target we can find
+		return;
 	}
-	
 	set_target_rotations(n_rotations);
+	if (mode == FIRING || mode == POST_FIRING){
+		target_pending = true; //wound to once the firing sequence is done
+		return;
+	}
+	if (mode == HOLDING_TARGET && n_rotations - encoder_steps() <= TARGET_TOLERANCE){
+		return; //already there, or past it (the springs can only be let out by firing)
+	}
+	if (mode != WINDING_TO_TARGET){
+		mode = WINDING_TO_TARGET;
+		timer->Reset();
+	}
 }
 
 void Winch::set_target_rotations(float target){
@@ -144,3 +267,7 @@ float Winch::computeEncoderStepsFromLength(float length){
 float Winch::computeEncoderStepsFromAngle(float angle){
 	return computeEncoderStepsFromLength(computeLengthFromAngle(angle));
 }
+
+float Winch::computeEncoderStepsFromDistance(float dist){
+	return computeEncoderStepsFromAngle(computeAngleFromDistance(dist));
+}
@@ -2,6 +2,10 @@
 #define WINCH_H_
 
 #include "WPILib.h"
+#include "InterpolatedTable.h"
+#include "OutputFrame.h"
+#include "SensorFrame.h"
+#include "StaticArena.h"
 
 /*
  * The class for the winch (including the piston, the motor and the limit switch)
@@ -9,19 +13,54 @@
  */
 class Winch {
 private:
-	typedef enum e_winch_mode {HOLDING, WINDING_BACK, FIRING, POST_FIRING} winch_mode;
+	typedef enum e_winch_mode {HOLDING, WINDING_BACK, FIRING, POST_FIRING, WINDING_TO_TARGET, HOLDING_TARGET} winch_mode;
 	winch_mode mode;
 	
 	Victor * winch_motor;
-	Solenoid * clutch;
+	OutputFrame * outputs;
+	int clutch;
 	Timer * timer;
-	bool clutch_position;
 	Encoder * winch_encoder;
+	SensorFrame * sensors;
+	int encoder_input;
 	DigitalInput * max_lim_switch;
 	static const bool CLUTCH_IN = true;
 	static const bool CLUTCH_OUT = false;
 
-	float target_rotations;
+	float target_rotations; //encoder steps of rope pulled in, counted from the catapult at rest
+	bool target_pending; //a target set while firing, wound to after it
+	bool encoder_zeroed;
+	
+	//distance -> encoder steps, precomputed when the winch is constructed
+	static const int SHOT_TABLE_SIZE = 256;
+	static const float SHOT_TABLE_MIN_DIST = 0.0f; //feet
+	static const float SHOT_TABLE_MAX_DIST = 63.75f; //feet, a little more than the field is long
+	InterpolatedTable<SHOT_TABLE_SIZE> shot_table;
+	
+	//winding to an encoder target (all in encoder steps)
+	static const float MAX_WIND_RATE = 500.0f; //steps per second at full power, winding against the springs
+	static const float WIND_DECELERATION = 1500.0f; //steps per second per second, when approaching the target
+	static const float WIND_RATE_GAIN = 0.002f; //extra power per step per second the winch is running slow
+	static const float TARGET_TOLERANCE = 4.0f; //close enough to call it there
+	static const float HOLD_GAIN = 0.02f; //power per step short of the target, while holding
+	static const float MAX_HOLD_POWER = 0.3f;
+	static const float WIND_DIRECTION = -1.0f; //motor sign that pulls rope in
+	
+	//the limit switch, kept up to date by its interrupt rather than read
+	volatile bool switch_closed;
+	//set when the switch closed while we were pulling; update() stops winding on it
+	volatile bool limit_stop;
+	
+	float encoder_steps();
+	float profiled_wind_power(float remaining);
+	bool pulling();
+	void pull(float power);
+	//limit switch interrupt, both edges: cuts the motor the moment the catapult seats
+	static void limit_switch_edge(UINT32 mask, void * winch);
+	
+
+public:
+	//the shot model's physical constants; sim/tools/ShotMonteCarlo.cpp samples around them
 	static const double PI = 3.1415926535;
 	static const int PULSES_PER_REV = 250;
 	static const float WINCH_CIRCUMFERENCE = 12.875;//INCHES!!!!!
@@ -39,16 +78,14 @@ private:
 	static const int NUM_SPRINGS = 3;
 	static const int CATAPULT_MASS = 1;//(kg) mass of catapult arm, we can play with this value
 	static const int GOAL_HEIGHT = 2;//Meters - height to center of goal
-	
-	float computeLengthFromAngle(float angle);//radians
-	float computeEncoderStepsFromLength(float length);//inches
-	float computeEncoderStepsFromAngle(float angle);//combines two previous functions
-	
-	
-public:
-	//the encoder doesn't do anything
-	//feel free to pass null if that's how it is
-	Winch(Victor * motor, Solenoid * sol, Encoder * encoder, DigitalInput * max_pos);
+
+	//the encoder is only needed for wind_back_rotations() and wind_back_dist()
+	//feel free to pass null if there isn't one; those two then just wind back to the limit switch
+	//the catapult must be at rest when this is constructed, that's where the encoder is zeroed
+	//the clutch is written when outputs is committed; the motor is written directly, so the
+	//limit switch interrupt can stop it; the encoder is read from sensors, latched each cycle
+	Winch(Victor * motor, Solenoid * sol, Encoder * encoder, DigitalInput * max_pos,
+			SensorFrame * sensors, OutputFrame * outputs, StaticArena * arena = NULL);
 	/*
 	 * After this function is called once, the winch winds back until it hits the limit switch.
 	 * Does nothing unless update() called in the same cycle
@@ -66,22 +103,45 @@ public:
 	 * functions to occur.
 	 */
 	void update(bool safety_mode=false);
-	/*returns whether the limit switch at the base of the catapult is hit*/
+	/*
+	 * returns whether the limit switch at the base of the catapult is hit
+	 * Latched by the switch's interrupt, so it doesn't read the switch
+	 */
 	bool wound_back();
+	/*
+	 * Whether a wind to an encoder target has got there (it keeps holding there until fire())
+	 */
+	bool at_target();
 	
-	//we don't actually use any of these next ones
-	//their behavior is officially undefined
-	
-	//probably harmless
+	//sets the target without starting to wind
 	void set_target_rotations(float n);
-	//definitely harmless
 	float get_target_rotations();
-	//would advise against calling this one
+	/*
+	 * Winds in n_rotations encoder steps of rope (counted from the catapult at rest), as fast as
+	 * the motor can while still stopping on the target, then holds it there.
+	 * Fine to call every cycle. A further target while holding winds on to it; a nearer one
+	 * holds where it is, since the springs can only be let out by firing. Called while
+	 * firing, the target is kept and wound to instead of the usual wind back afterwards.
+	 * The limit switch still stops it. Does nothing unless update() called in the same cycle
+	 */
 	void wind_back_rotations(float n_rotations);
-	//leave this guy alone too
+	//like wind_back_rotations(), with the target from the shot table for a shot from dist feet;
+	//where the table has no answer, winds back to the limit switch like wind_back()
 	void wind_back_dist(float dist);
 	//harmless. call it all you want. Math is fun!
-	float computeAngleFromDistance(float dist);//input dist in feet
+	//these evaluate the physics directly, so they're slow; use lookup_encoder_steps() in the loop
+	static float computeAngleFromDistance(float dist);//input dist in feet
+	static float computeLengthFromAngle(float angle);//radians
+	static float computeEncoderStepsFromLength(float length);//inches
+	static float computeEncoderStepsFromAngle(float angle);//combines two previous functions
+	static float computeEncoderStepsFromDistance(float dist);//all of the above, feet to steps
+	
+	/*
+	 * Encoder steps to wind back for a shot from dist feet, interpolated from the shot table
+	 * Returns false if dist is off the table or the model has no answer there (NaN)
+	 */
+	bool lookup_encoder_steps(float dist, float &steps);
+	int shot_table_valid_segments() { return shot_table.valid_segments(); }
 };
 
 
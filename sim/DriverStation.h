@@ -0,0 +1,7 @@
+#ifndef SIM_DRIVERSTATION_H_
+#define SIM_DRIVERSTATION_H_
+
+//the real WPILib splits this into its own header; the simulation keeps everything in WPILib.h
+#include "WPILib.h"
+
+#endif
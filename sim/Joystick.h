@@ -0,0 +1,7 @@
+#ifndef SIM_JOYSTICK_H_
+#define SIM_JOYSTICK_H_
+
+//the real WPILib splits this into its own header; the simulation keeps everything in WPILib.h
+#include "WPILib.h"
+
+#endif
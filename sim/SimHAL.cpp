@@ -0,0 +1,57 @@
+#include "SimHAL.h"
+#include "WPILib.h"
+#include <string.h>
+
+float SimHAL::pwm[SimHAL::NUM_PWM + 1];
+bool SimHAL::solenoid[SimHAL::NUM_SOLENOID + 1];
+bool SimHAL::relay_forward[SimHAL::NUM_RELAY + 1];
+char SimHAL::lcd[SimHAL::LCD_LINES][SimHAL::LCD_LINE_LENGTH + 1];
+UINT32 SimHAL::dio[SimHAL::NUM_DIO + 1];
+INT32 SimHAL::encoder_count[SimHAL::NUM_DIO + 1];
+double SimHAL::encoder_rate[SimHAL::NUM_DIO + 1];
+float SimHAL::ultrasonic_range[SimHAL::NUM_DIO + 1];
+SimHAL::robot_mode SimHAL::mode = SimHAL::DISABLED;
+bool SimHAL::blue_alliance = false;
+float SimHAL::stick_axes[SimHAL::NUM_STICKS + 1][SimHAL::NUM_AXES + 1];
+UINT16 SimHAL::stick_buttons[SimHAL::NUM_STICKS + 1];
+
+double SimClock::now = 0.0;
+
+void SimHAL::Reset(){
+	memset(pwm, 0, sizeof(pwm));
+	memset(solenoid, 0, sizeof(solenoid));
+	memset(relay_forward, 0, sizeof(relay_forward));
+	memset(lcd, 0, sizeof(lcd));
+	for (int i = 0; i <= NUM_DIO; i++){
+		dio[i] = 1; //sidecar pull-ups
+		encoder_count[i] = 0;
+		encoder_rate[i] = 0.0;
+		ultrasonic_range[i] = 0.0f;
+	}
+	mode = DISABLED;
+	blue_alliance = false;
+	memset(stick_axes, 0, sizeof(stick_axes));
+	memset(stick_buttons, 0, sizeof(stick_buttons));
+}
+
+void SimHAL::SetDigitalInput(int channel, UINT32 value){
+	UINT32 old = dio[channel];
+	dio[channel] = value;
+	if ((old != 0) != (value != 0)){
+		DigitalInput::SimEdge(channel, value != 0);
+	}
+}
+
+double SimClock::Now(){
+	return now;
+}
+
+void SimClock::Advance(double dt){
+	double end = now + dt;
+	Notifier::RunUntil(end);
+	now = end;
+}
+
+void SimClock::Reset(){
+	now = 0.0;
+}
@@ -0,0 +1,76 @@
+#ifndef SIM_HAL_H_
+#define SIM_HAL_H_
+
+#include "vxWorks.h"
+
+/*
+ * The simulated "hardware" behind the stand-in WPILib classes.
+ * Every port the robot code can touch is a plain array slot here, indexed by the
+ * same channel numbers AerialAssistRobot.h uses (slot 0 is unused, like on the sidecar).
+ * WPILib objects read and write these slots; the simulation driver and the plant
+ * models (SimPlant.h) read the outputs and write the inputs.
+ * Nothing in here allocates, so stepping it is just a few stores per cycle.
+ */
+class SimHAL {
+public:
+	static const int NUM_PWM = 10;
+	static const int NUM_DIO = 14;
+	static const int NUM_SOLENOID = 8;
+	static const int NUM_RELAY = 8;
+	static const int NUM_STICKS = 4;
+	static const int NUM_AXES = 6;
+	static const int LCD_LINES = 6;
+	static const int LCD_LINE_LENGTH = 21;
+
+	typedef enum {DISABLED, AUTONOMOUS, TELEOP, TEST} robot_mode;
+
+	//outputs
+	static float pwm[NUM_PWM + 1];
+	static bool solenoid[NUM_SOLENOID + 1];
+	static bool relay_forward[NUM_RELAY + 1];
+	static char lcd[LCD_LINES][LCD_LINE_LENGTH + 1];
+
+	//digital IO is shared between inputs and outputs, like the real sidecar
+	//unconnected inputs read 1 because of the sidecar pull-ups
+	static UINT32 dio[NUM_DIO + 1];
+
+	//quadrature encoders, indexed by their A channel
+	static INT32 encoder_count[NUM_DIO + 1];
+	static double encoder_rate[NUM_DIO + 1]; //counts per second
+
+	//ultrasonic sensors, indexed by their ping channel. 0 means no echo comes back.
+	static float ultrasonic_range[NUM_DIO + 1]; //inches
+
+	//driver station
+	static robot_mode mode;
+	static bool blue_alliance;
+	static float stick_axes[NUM_STICKS + 1][NUM_AXES + 1];
+	static UINT16 stick_buttons[NUM_STICKS + 1];
+
+	//puts every port back to its power-on value
+	static void Reset();
+	//changes a digital input, firing its interrupt if the edge matches
+	static void SetDigitalInput(int channel, UINT32 value);
+};
+
+/*
+ * Virtual time for the simulation.
+ * Timer, GetFPGATime() and Notifier all read this instead of the wall clock, so the
+ * robot code runs as fast as the host can execute it.
+ */
+class SimClock {
+public:
+	static double Now(); //seconds since the simulation started
+	/*
+	 * Moves time forward by dt seconds.
+	 * Any Notifier that comes due along the way is fired at its own scheduled time,
+	 * in order, so periodic handlers see the same spacing they would on the robot.
+	 */
+	static void Advance(double dt);
+	static void Reset();
+private:
+	friend class Notifier; //moves the clock to each handler's scheduled time while firing it
+	static double now;
+};
+
+#endif
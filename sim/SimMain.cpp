@@ -0,0 +1,242 @@
+/*
+ * Runs the real robot code (2014robot/) against the simulated HAL.
+ * Each match is disabled -> autonomous -> disabled -> teleop (or test), stepped one
+ * driver station packet (20 ms of virtual time) at a time, with no sleeping, so it
+ * runs as fast as the host allows. Between packets the plant models (SimPlant.h) step
+ * at -rate Hz, so the sensors follow what the robot does with its outputs.
+ * -winch runs a check of the winch's wind to an encoder target against the catapult plant
+ * instead of any matches, and exits nonzero if it fails.
+ *
+ * usage: robotsim [-n matches] [-test] [-blue] [-v] [-rate hz] [-winch]
+ */
+#include "WPILib.h"
+#include "SimPlant.h"
+#include "Winch.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const double PACKET_PERIOD = 0.02;
+static const double PRE_MATCH_TIME = 1.0;
+static const double AUTONOMOUS_TIME = 10.0;
+static const double TRANSITION_TIME = 1.0;
+static const double TELEOP_TIME = 140.0;
+
+//channels the scripted inputs use; these match AerialAssistRobot.h and Gamepad.h
+static const int PILOT = 1;
+static const int COPILOT = 2;
+static const int LEFT_Y_AXIS = 2;
+static const int RIGHT_X_AXIS = 3;
+static const int BUTTON_A = 1;
+static const int BUTTON_B = 2;
+static const int BUTTON_X = 3;
+static const int BUTTON_BACK = 7;
+static const int WINCH_PWM = 9;
+static const int CLUTCH_SOL = 2;
+static const int WINCH_ENCODER_A_CHANNEL = 5;
+static const int WINCH_ENCODER_B_CHANNEL = 8;
+static const int WINCH_MAX_LIMIT_DIO = 4;
+
+static bool verbose = false;
+static SimPlants plants;
+static double plant_rate = SimPlants::DEFAULT_RATE;
+
+static double wall_time(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+static void set_button(int stick, int button, bool pressed){
+	if (pressed){
+		SimHAL::stick_buttons[stick] |= (1 << (button - 1));
+	} else {
+		SimHAL::stick_buttons[stick] &= ~(1 << (button - 1));
+	}
+}
+
+/*
+ * A canned driver so teleop exercises the drive, load and fire paths.
+ * Repeats every 20 seconds: drive around while holding X to run the load sequence,
+ * tap A to feed the ball in, then tap B to fire, then hold back to wind for the range.
+ */
+static void script_drivers(double t){
+	SimHAL::stick_axes[PILOT][LEFT_Y_AXIS] = (float)(-0.8 * sin(t * 0.5));
+	SimHAL::stick_axes[PILOT][RIGHT_X_AXIS] = (float)(0.3 * sin(t * 0.13));
+
+	double cycle_t = fmod(t, 20.0);
+	set_button(COPILOT, BUTTON_X, cycle_t < 8.0);
+	set_button(COPILOT, BUTTON_A, cycle_t > 9.0 && cycle_t < 10.0);
+	set_button(COPILOT, BUTTON_B, cycle_t > 12.0 && cycle_t < 12.1);
+	set_button(COPILOT, BUTTON_BACK, cycle_t > 16.0 && cycle_t < 17.0);
+}
+
+static void print_lcd(const char *label){
+	if (!verbose){
+		return;
+	}
+	printf("[%8.2f] %s\n", SimClock::Now(), label);
+	for (int i = 0; i < SimHAL::LCD_LINES; i++){
+		printf("    |%s|\n", SimHAL::lcd[i]);
+	}
+}
+
+//steps the robot through one mode for the given amount of virtual time, returns the number of loops
+static long run_mode(IterativeRobot *robot, SimHAL::robot_mode mode, double duration, bool scripted){
+	SimHAL::mode = mode;
+	long loops = 0;
+	double start = SimClock::Now();
+	while (SimClock::Now() - start < duration - PACKET_PERIOD / 2){
+		if (scripted){
+			script_drivers(SimClock::Now() - start);
+		} else {
+			memset(SimHAL::stick_axes, 0, sizeof(SimHAL::stick_axes));
+			memset(SimHAL::stick_buttons, 0, sizeof(SimHAL::stick_buttons));
+		}
+		//the plants run in between packets, and the robot's notifiers fire in step with them
+		int steps = (int)floor(PACKET_PERIOD * plant_rate + 0.5);
+		double dt = PACKET_PERIOD / steps;
+		for (int i = 0; i < steps; i++){
+			plants.step(dt);
+			SimClock::Advance(dt);
+		}
+		robot->LoopOnce();
+		loops++;
+	}
+	return loops;
+}
+
+//runs the winch the way the scheduler does, target (if any) set every cycle, for seconds of virtual time
+static void run_winch(Winch &winch, SensorFrame &sensors, OutputFrame &outputs, double seconds, float target){
+	static const double WINCH_PERIOD = 0.01;
+	int steps = (int)floor(WINCH_PERIOD * plant_rate + 0.5);
+	double dt = WINCH_PERIOD / steps;
+	double start = SimClock::Now();
+	while (SimClock::Now() - start < seconds - WINCH_PERIOD / 2){
+		sensors.latch();
+		if (target > 0.0f){
+			winch.wind_back_rotations(target);
+		}
+		winch.update();
+		outputs.commit();
+		for (int i = 0; i < steps; i++){
+			plants.step(dt);
+			SimClock::Advance(dt);
+		}
+	}
+	sensors.latch();
+}
+
+static int check(bool ok, const char * what, double steps){
+	printf("  %-44s %7.1f steps  %s\n", what, steps, ok ? "ok" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+/*
+ * Winds to a target, holds it, winds on to a further one, and fires with a new target
+ * set every cycle (it should be wound to after the shot); returns the number of failures
+ */
+static int check_winch(){
+	static const float TOLERANCE = 8.0f; //steps; the winch's own tolerance, plus a cycle of travel
+	Victor motor(WINCH_PWM);
+	Solenoid clutch(CLUTCH_SOL);
+	Encoder encoder(WINCH_ENCODER_A_CHANNEL, WINCH_ENCODER_B_CHANNEL);
+	DigitalInput max_switch(WINCH_MAX_LIMIT_DIO);
+	SensorFrame sensors;
+	OutputFrame outputs;
+	Winch winch(&motor, &clutch, &encoder, &max_switch, &sensors, &outputs);
+	int encoder_input = sensors.add(&encoder);
+	int failures = 0;
+	printf("winch check\n");
+
+	double start = SimClock::Now();
+	while (!winch.at_target() && SimClock::Now() - start < 4.0){
+		run_winch(winch, sensors, outputs, 0.01, 200.0f);
+	}
+	double steps = sensors.get_count(encoder_input);
+	printf("  reached 200 steps in %.2f s\n", SimClock::Now() - start);
+	failures += check(winch.at_target() && fabs(steps - 200.0) <= TOLERANCE, "wind to 200", steps);
+
+	run_winch(winch, sensors, outputs, 2.0, 200.0f);
+	steps = sensors.get_count(encoder_input);
+	failures += check(winch.at_target() && fabs(steps - 200.0) <= TOLERANCE, "hold 200 for 2 s", steps);
+
+	run_winch(winch, sensors, outputs, 2.0, 300.0f);
+	steps = sensors.get_count(encoder_input);
+	failures += check(winch.at_target() && fabs(steps - 300.0) <= TOLERANCE, "wind on to 300", steps);
+
+	run_winch(winch, sensors, outputs, 1.0, 250.0f);
+	steps = sensors.get_count(encoder_input);
+	failures += check(winch.at_target() && steps >= 300.0 - TOLERANCE, "ask for 250, keep holding 300", steps);
+
+	UINT32 fired = plants.catapult.get_dry_fires();
+	winch.fire();
+	run_winch(winch, sensors, outputs, 6.0, 150.0f);
+	steps = sensors.get_count(encoder_input);
+	failures += check(plants.catapult.get_dry_fires() == fired + 1, "fire with 150 asked for every cycle", steps);
+	failures += check(winch.at_target() && fabs(steps - 150.0) <= TOLERANCE, "wound to 150 after firing", steps);
+
+	printf("winch check: %s\n", failures ? "FAILED" : "passed");
+	return failures;
+}
+
+int main(int argc, char **argv){
+	int matches = 1;
+	bool test_mode = false;
+	bool blue = false;
+	bool winch_check = false;
+	for (int i = 1; i < argc; i++){
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc){
+			matches = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-test") == 0){
+			test_mode = true;
+		} else if (strcmp(argv[i], "-blue") == 0){
+			blue = true;
+		} else if (strcmp(argv[i], "-v") == 0){
+			verbose = true;
+		} else if (strcmp(argv[i], "-rate") == 0 && i + 1 < argc){
+			plant_rate = atof(argv[++i]);
+			if (plant_rate < 1.0 / PACKET_PERIOD){
+				plant_rate = 1.0 / PACKET_PERIOD;
+			}
+		} else if (strcmp(argv[i], "-winch") == 0){
+			winch_check = true;
+		} else {
+			fprintf(stderr, "usage: %s [-n matches] [-test] [-blue] [-v] [-rate hz] [-winch]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	SimHAL::Reset();
+	SimClock::Reset();
+	SimHAL::blue_alliance = blue;
+	plants.reset(); //before the robot reads any sensors
+	if (winch_check){
+		return check_winch() ? 1 : 0;
+	}
+
+	IterativeRobot *robot = (IterativeRobot *)FRC_userClassFactory();
+	robot->StartCompetition();
+
+	long loops = 0;
+	double wall_start = wall_time();
+	for (int match = 0; match < matches; match++){
+		loops += run_mode(robot, SimHAL::DISABLED, PRE_MATCH_TIME, false);
+		loops += run_mode(robot, SimHAL::AUTONOMOUS, AUTONOMOUS_TIME, false);
+		print_lcd("end of autonomous");
+		loops += run_mode(robot, SimHAL::DISABLED, TRANSITION_TIME, false);
+		loops += run_mode(robot, test_mode ? SimHAL::TEST : SimHAL::TELEOP, TELEOP_TIME, true);
+		print_lcd(test_mode ? "end of test" : "end of teleop");
+	}
+	SimHAL::mode = SimHAL::DISABLED;
+	robot->LoopOnce();
+	double wall_elapsed = wall_time() - wall_start;
+
+	double simulated = SimClock::Now();
+	printf("%d match(es), %ld loops, %.1f s simulated in %.3f s wall (%.0fx real time)\n",
+			matches, loops, simulated, wall_elapsed, wall_elapsed > 0.0 ? simulated / wall_elapsed : 0.0);
+	plants.print_summary();
+	return 0;
+}
@@ -0,0 +1,339 @@
+#include "SimPlant.h"
+#include <math.h>
+#include <stdio.h>
+
+static const double GRAVITY = 9.8; //m/s^2
+static const double METERS_PER_INCH = 0.0254;
+
+//channels, as in AerialAssistRobot.h
+static const int ROLLER_PWM = 1;
+static const int ARM_LIFT_PWM = 2;
+static const int FRONT_LEFT_DRIVE_PWM = 3;
+static const int REAR_LEFT_DRIVE_PWM = 4;
+static const int FRONT_RIGHT_DRIVE_PWM = 7;
+static const int REAR_RIGHT_DRIVE_PWM = 8;
+static const int WINCH_PWM = 9;
+static const int WINCH_MAX_LIMIT_DIO = 4;
+static const int ARM_FLOOR_SWITCH_DIO = 5;
+static const int ARM_TOP_SWITCH_DIO = 7;
+static const int ARM_LINE_BREAK_DIO = 9;
+static const int RANGE_FINDER_PING_CHANNEL_DIO = 13;
+static const int ARM_ENCODER_A_CHANNEL = 1;
+static const int WINCH_ENCODER_A_CHANNEL = 5;
+static const int GEAR_SHIFT_SOL_FORWARD = 8; //low gear
+static const int GEAR_SHIFT_SOL_REVERSE = 1; //high gear
+static const int CLUTCH_SOL = 2; //on is in
+
+//drive
+static const double ROBOT_MASS = 54.0; //kg, about 120 lb with battery and bumpers
+static const double CIM_STALL_TORQUE = 2.42; //N m
+static const double CIM_FREE_SPEED = 5310.0 * 2.0 * M_PI / 60.0; //rad/s
+static const double LOW_GEAR_RATIO = 19.0;
+static const double HIGH_GEAR_RATIO = 7.0;
+static const double WHEEL_RADIUS = 2.0 * METERS_PER_INCH;
+static const double WHEEL_FRICTION = 1.0; //coefficient, so a side can push with half the robot's weight
+static const double TRACK_WIDTH = 0.6; //meters
+static const double START_RANGE = 120.0; //inches from the ultrasonic to the wall
+static const double BUMPER_RANGE = 6.0; //inches, what the ultrasonic reads with the bumpers on the wall
+static const double FIELD_LENGTH = 16.5; //meters
+static const double FIELD_HALF_WIDTH = 3.8;
+static const double MAX_ECHO_RANGE = 250.0; //inches
+static const double MAX_ECHO_ANGLE = 0.35; //radians off square to the wall
+
+//arm
+static const double ARM_MASS = 3.0; //kg
+static const double ARM_LENGTH = 0.5; //meters, pivot to roller
+static const double BALL_MASS = 1.25; //kg
+static const double ARM_STALL_TORQUE = 60.0; //N m at the pivot, full output
+static const double ARM_FREE_SPEED = M_PI; //rad/s at full output
+//the switches close at Arm's TOP_POSITION and FLOOR_POSITION, 50 ticks over the 90 degrees,
+//and the hard stops are a tick past them
+static const double TOP_SWITCH_ANGLE = 0.0; //radians
+static const double FLOOR_SWITCH_ANGLE = M_PI / 2.0;
+static const double TICKS_PER_RADIAN = 50.0 / (M_PI / 2.0);
+static const double TOP_STOP = TOP_SWITCH_ANGLE - 1.0 / TICKS_PER_RADIAN;
+static const double FLOOR_STOP = FLOOR_SWITCH_ANGLE + 1.0 / TICKS_PER_RADIAN;
+static const double NEAR_TOP = 0.09; //radians; close enough to feed the catapult
+static const double NEAR_FLOOR = FLOOR_SWITCH_ANGLE - 0.09; //close enough to pick up a ball
+static const float ROLLER_DEADBAND = 0.1f;
+static const double PICKUP_TIME = 0.25; //seconds of roller to get a ball in, or out
+static const double FEED_TIME = 0.5;
+static const double EJECT_TIME = 0.25;
+
+//catapult
+static const double SPRING_RATE = 3 * 60.25; //N m per radian, three springs
+static const double CATAPULT_LENGTH = 0.42; //meters, pivot to ball
+static const double CATAPULT_INERTIA = 1.0 * CATAPULT_LENGTH * CATAPULT_LENGTH / 3.0; //a 1 kg bar
+static const double WINCH_STALL_TORQUE = 600.0; //N m at the catapult, full output
+static const double WINCH_FREE_SPEED = 3.0; //catapult rad/s at full output
+static const double WIND_DIRECTION = -1.0; //motor sign that pulls rope in, like Winch's
+static const double STEPS_PER_RADIAN = 253.0; //near enough, see Winch::computeEncoderStepsFromAngle
+static const double MAX_ANGLE = 1.5; //radians, the bottom of the catapult's travel
+static const double SWITCH_CLOSES = 1.45; //radians
+static const double SWITCH_OPENS = 1.43;
+
+DrivePlant::DrivePlant() {
+	reset();
+}
+
+void DrivePlant::reset() {
+	x = 0.0;
+	y = 0.0;
+	heading = 0.0;
+	left_speed = 0.0;
+	right_speed = 0.0;
+	low_gear = false;
+	distance_driven = 0.0;
+	SimHAL::ultrasonic_range[RANGE_FINDER_PING_CHANNEL_DIO] = (float)START_RANGE;
+}
+
+//force from one side's two motors, through the gearbox, as much as the wheels can put down
+double DrivePlant::side_force(float output_a, float output_b, double speed) {
+	double ratio = low_gear ? LOW_GEAR_RATIO : HIGH_GEAR_RATIO;
+	double free_speed = CIM_FREE_SPEED / ratio * WHEEL_RADIUS;
+	double stall_force = CIM_STALL_TORQUE * ratio / WHEEL_RADIUS;
+	double force = stall_force * ((output_a - speed / free_speed) + (output_b - speed / free_speed));
+	double traction = WHEEL_FRICTION * ROBOT_MASS * GRAVITY / 2.0;
+	if (force > traction) {
+		return traction;
+	} else if (force < -traction) {
+		return -traction;
+	}
+	return force;
+}
+
+void DrivePlant::step(double dt) {
+	if (SimHAL::solenoid[GEAR_SHIFT_SOL_FORWARD]) {
+		low_gear = true;
+	} else if (SimHAL::solenoid[GEAR_SHIFT_SOL_REVERSE]) {
+		low_gear = false;
+	} //neither: the shifter stays where it was
+
+	//RobotDrive runs the right side backwards
+	double left_force = side_force(SimHAL::pwm[FRONT_LEFT_DRIVE_PWM], SimHAL::pwm[REAR_LEFT_DRIVE_PWM], left_speed);
+	double right_force = side_force(-SimHAL::pwm[FRONT_RIGHT_DRIVE_PWM], -SimHAL::pwm[REAR_RIGHT_DRIVE_PWM], right_speed);
+	left_speed += left_force / (ROBOT_MASS / 2.0) * dt;
+	right_speed += right_force / (ROBOT_MASS / 2.0) * dt;
+
+	double speed = 0.5 * (left_speed + right_speed);
+	heading += (right_speed - left_speed) / TRACK_WIDTH * dt;
+	if (heading > M_PI) {
+		heading -= 2.0 * M_PI;
+	} else if (heading < -M_PI) {
+		heading += 2.0 * M_PI;
+	}
+	x += speed * cos(heading) * dt;
+	y += speed * sin(heading) * dt;
+	distance_driven += fabs(speed) * dt;
+
+	//the walls stop it dead
+	double wall = (START_RANGE - BUMPER_RANGE) * METERS_PER_INCH;
+	if (x > wall || x < wall - FIELD_LENGTH || fabs(y) > FIELD_HALF_WIDTH) {
+		x = x > wall ? wall : (x < wall - FIELD_LENGTH ? wall - FIELD_LENGTH : x);
+		y = y > FIELD_HALF_WIDTH ? FIELD_HALF_WIDTH : (y < -FIELD_HALF_WIDTH ? -FIELD_HALF_WIDTH : y);
+		left_speed = 0.0;
+		right_speed = 0.0;
+	}
+
+	float range = 0.0f; //no echo
+	if (fabs(heading) < MAX_ECHO_ANGLE) {
+		double inches = (wall - x) / METERS_PER_INCH / cos(heading) + BUMPER_RANGE;
+		if (inches < MAX_ECHO_RANGE) {
+			range = (float)inches;
+		}
+	}
+	SimHAL::ultrasonic_range[RANGE_FINDER_PING_CHANNEL_DIO] = range;
+}
+
+ArmPlant::ArmPlant() {
+	reset();
+}
+
+void ArmPlant::reset() {
+	angle = TOP_STOP;
+	speed = 0.0;
+	ball = true; //the match starts with one in the arm
+	roller_time = 0.0;
+	roller_action = 0;
+	fed = false;
+	pickups = 0;
+	feeds = 0;
+	update_sensors();
+}
+
+void ArmPlant::step(double dt) {
+	double inertia = ARM_MASS * ARM_LENGTH * ARM_LENGTH / 3.0;
+	double gravity_moment = ARM_MASS * ARM_LENGTH / 2.0;
+	if (ball) {
+		inertia += BALL_MASS * ARM_LENGTH * ARM_LENGTH;
+		gravity_moment += BALL_MASS * ARM_LENGTH;
+	}
+	//positive output drives it down, like the arm code expects
+	double motor = ARM_STALL_TORQUE * (SimHAL::pwm[ARM_LIFT_PWM] - speed / ARM_FREE_SPEED);
+	double gravity = GRAVITY * gravity_moment * sin(angle);
+	speed += (motor + gravity) / inertia * dt;
+	angle += speed * dt;
+	if (angle < TOP_STOP) {
+		angle = TOP_STOP;
+		if (speed < 0.0) {
+			speed = 0.0;
+		}
+	} else if (angle > FLOOR_STOP) {
+		angle = FLOOR_STOP;
+		if (speed > 0.0) {
+			speed = 0.0;
+		}
+	}
+	update_roller(dt);
+	update_sensors();
+}
+
+//what the roller's doing to the ball: 0 nothing, 1 picking one up, 2 feeding it to the catapult, 3 dropping it
+void ArmPlant::update_roller(double dt) {
+	float roller = SimHAL::pwm[ROLLER_PWM];
+	int action = 0;
+	if (roller > ROLLER_DEADBAND) {
+		if (!ball && angle > NEAR_FLOOR) {
+			action = 1;
+		} else if (ball && angle < NEAR_TOP) {
+			action = 2;
+		}
+	} else if (roller < -ROLLER_DEADBAND && ball) {
+		action = 3;
+	}
+	if (action != roller_action) {
+		roller_action = action;
+		roller_time = 0.0;
+		return;
+	}
+	roller_time += dt;
+	if (action == 1 && roller_time >= PICKUP_TIME) {
+		ball = true;
+		pickups++;
+	} else if (action == 2 && roller_time >= FEED_TIME) {
+		ball = false;
+		fed = true;
+		feeds++;
+	} else if (action == 3 && roller_time >= EJECT_TIME) {
+		ball = false;
+	}
+}
+
+bool ArmPlant::take_fed_ball() {
+	bool was_fed = fed;
+	fed = false;
+	return was_fed;
+}
+
+void ArmPlant::update_sensors() {
+	SimHAL::encoder_count[ARM_ENCODER_A_CHANNEL] = (INT32)floor(angle * TICKS_PER_RADIAN + 0.5);
+	SimHAL::encoder_rate[ARM_ENCODER_A_CHANNEL] = speed * TICKS_PER_RADIAN;
+	//all three read 0 when they're made
+	SimHAL::SetDigitalInput(ARM_TOP_SWITCH_DIO, angle <= TOP_SWITCH_ANGLE ? 0 : 1);
+	SimHAL::SetDigitalInput(ARM_FLOOR_SWITCH_DIO, angle >= FLOOR_SWITCH_ANGLE ? 0 : 1);
+	SimHAL::SetDigitalInput(ARM_LINE_BREAK_DIO, ball ? 0 : 1);
+}
+
+CatapultPlant::CatapultPlant() {
+	reset();
+}
+
+void CatapultPlant::reset() {
+	angle = 0.0;
+	speed = 0.0;
+	drum_steps = 0.0;
+	loaded = false;
+	releasing = false;
+	release_angle = 0.0;
+	shots = 0;
+	dry_fires = 0;
+	launch_speed_total = 0.0;
+	SimHAL::SetDigitalInput(WINCH_MAX_LIMIT_DIO, 0);
+	update_sensors(0.0);
+}
+
+void CatapultPlant::step(double dt) {
+	double pull = WIND_DIRECTION * SimHAL::pwm[WINCH_PWM]; //positive winds rope in
+	double drum_rate; //in catapult radians per second
+	if (SimHAL::solenoid[CLUTCH_SOL]) {
+		releasing = false; //if it was still swinging, the rope catches it
+		//a worm gearbox: the motor slows with the springs' load, and they can't back it out
+		double rate = WINCH_FREE_SPEED * (pull - SPRING_RATE * angle / WINCH_STALL_TORQUE);
+		if (pull >= 0.0 && rate < 0.0) {
+			rate = 0.0;
+		} else if (pull < 0.0) {
+			rate = WINCH_FREE_SPEED * pull; //unwinding, and the springs are happy to help
+		}
+		angle += rate * dt;
+		if (angle > MAX_ANGLE) {
+			angle = MAX_ANGLE;
+			rate = 0.0; //stalled against the bottom
+		} else if (angle < 0.0) {
+			angle = 0.0; //at rest; more rope just goes slack
+		}
+		speed = rate;
+		drum_rate = rate;
+	} else {
+		drum_rate = WINCH_FREE_SPEED * pull; //the drum spins free
+		if (angle > 0.0) {
+			if (!releasing) {
+				releasing = true;
+				release_angle = angle;
+				speed = 0.0;
+			}
+			double inertia = CATAPULT_INERTIA;
+			if (loaded) {
+				inertia += BALL_MASS * CATAPULT_LENGTH * CATAPULT_LENGTH;
+			}
+			speed -= SPRING_RATE * angle / inertia * dt;
+			angle += speed * dt;
+			if (angle <= 0.0) {
+				if (loaded) {
+					shots++;
+					launch_speed_total += -speed * CATAPULT_LENGTH;
+					loaded = false;
+				} else {
+					dry_fires++;
+				}
+				angle = 0.0;
+				speed = 0.0;
+				releasing = false;
+			}
+		}
+	}
+	drum_steps += drum_rate * STEPS_PER_RADIAN * dt;
+	update_sensors(drum_rate);
+}
+
+void CatapultPlant::update_sensors(double drum_rate) {
+	SimHAL::encoder_count[WINCH_ENCODER_A_CHANNEL] = (INT32)floor(drum_steps);
+	SimHAL::encoder_rate[WINCH_ENCODER_A_CHANNEL] = drum_rate * STEPS_PER_RADIAN;
+	//closed (1) at the bottom of the travel, with a little hysteresis like a real lever switch
+	if (angle >= SWITCH_CLOSES) {
+		SimHAL::SetDigitalInput(WINCH_MAX_LIMIT_DIO, 1);
+	} else if (angle < SWITCH_OPENS) {
+		SimHAL::SetDigitalInput(WINCH_MAX_LIMIT_DIO, 0);
+	}
+}
+
+void SimPlants::reset() {
+	drive.reset();
+	arm.reset();
+	catapult.reset();
+}
+
+void SimPlants::step(double dt) {
+	drive.step(dt);
+	arm.step(dt);
+	if (arm.take_fed_ball()) {
+		catapult.load_ball();
+	}
+	catapult.step(dt);
+}
+
+void SimPlants::print_summary() {
+	printf("plants: drove %.1f m, arm picked up %u balls and fed %u to the catapult, "
+			"%u shots (%.1f m/s launch on average), %u dry fires\n",
+			drive.get_distance_driven(), arm.get_pickups(), arm.get_feeds(), catapult.get_shots(),
+			catapult.get_mean_launch_speed(), catapult.get_dry_fires());
+}
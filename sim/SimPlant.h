@@ -0,0 +1,121 @@
+#ifndef SIM_PLANT_H_
+#define SIM_PLANT_H_
+
+#include "SimHAL.h"
+
+/*
+ * Physics behind the robot's outputs, so the simulated sensors answer back.
+ * Each plant reads its motor and solenoid outputs from SimHAL, integrates one fixed step,
+ * and writes the encoders, switches and range the robot code reads (switches through
+ * SimHAL::SetDigitalInput(), so their interrupts fire). Step them at a fixed rate, 1 kHz
+ * or so, between SimClock advances. Nothing allocates, and a step is a few dozen flops.
+ * The constants are reasonable guesses for a 2014 robot, not measurements; the channels
+ * match AerialAssistRobot.h.
+ */
+
+/*
+ * Skid steer drive: two CIMs a side through a two speed gearbox, shifted by the gear shift
+ * solenoids. Each side is a DC motor model (force falls off linearly with speed), limited
+ * by traction. The robot starts facing the goal wall; the ultrasonic sees the wall while
+ * the robot is facing it closely enough.
+ */
+class DrivePlant {
+public:
+	DrivePlant();
+	void reset();
+	void step(double dt);
+	double get_distance_driven() { return distance_driven; } //meters, either way
+	bool in_low_gear() { return low_gear; }
+private:
+	double x; //meters towards the wall from the start
+	double y; //meters to the left
+	double heading; //radians, 0 facing the wall
+	double left_speed; //meters per second
+	double right_speed;
+	bool low_gear;
+	double distance_driven;
+
+	double side_force(float output_a, float output_b, double speed);
+};
+
+/*
+ * The arm pivot: a motor through a big reduction against gravity, which pulls the arm down
+ * harder the further it is from straight up, and harder with a ball in it. It rests against
+ * hard stops just past the top and floor switches. The encoder reads 50 ticks over
+ * the 90 degrees, counting from the top, like Arm's.
+ * Also the roller and the line break: running the roller in at the floor picks up a ball
+ * (there's always one there), running it in at the top feeds the ball to the catapult, and
+ * running it out drops the ball.
+ */
+class ArmPlant {
+public:
+	ArmPlant();
+	void reset();
+	void step(double dt);
+	bool has_ball() { return ball; }
+	//true once for each ball fed to the catapult
+	bool take_fed_ball();
+	UINT32 get_pickups() { return pickups; }
+	UINT32 get_feeds() { return feeds; }
+private:
+	double angle; //radians down from straight up
+	double speed; //radians per second
+	bool ball;
+	double roller_time; //how long the roller has been doing what it's doing where it is
+	int roller_action;
+	bool fed;
+	UINT32 pickups;
+	UINT32 feeds;
+
+	void update_sensors();
+	void update_roller(double dt);
+};
+
+/*
+ * The catapult: springs pulling it up, a winch and rope pulling it down through the clutch,
+ * and the max limit switch at the bottom of its travel.
+ * With the clutch in, the winch's speed falls off with the springs' load; it's a worm drive,
+ * so the springs can't back it out when the motor stops or stalls. With the clutch
+ * out, the winch drum spins free and the springs fling the catapult back up, launching the
+ * ball if there is one. The encoder is on the drum.
+ */
+class CatapultPlant {
+public:
+	CatapultPlant();
+	void reset();
+	void step(double dt);
+	void load_ball() { loaded = true; }
+	UINT32 get_shots() { return shots; }
+	UINT32 get_dry_fires() { return dry_fires; }
+	double get_mean_launch_speed() { return shots ? launch_speed_total / shots : 0.0; } //m/s
+private:
+	double angle; //radians pulled back from rest
+	double speed; //radians per second, positive pulling back
+	double drum_steps; //encoder steps, positive winding in
+	bool loaded;
+	bool releasing; //clutch out with the catapult still pulled back
+	double release_angle;
+	UINT32 shots;
+	UINT32 dry_fires;
+	double launch_speed_total;
+
+	void update_sensors(double drum_rate);
+};
+
+/*
+ * All the plants, and the ball's trip from the arm to the catapult
+ */
+class SimPlants {
+public:
+	static const double DEFAULT_RATE = 1000.0; //Hz
+
+	void reset();
+	void step(double dt);
+	void print_summary();
+
+	DrivePlant drive;
+	ArmPlant arm;
+	CatapultPlant catapult;
+};
+
+#endif
@@ -0,0 +1,814 @@
+#include "WPILib.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+double GetTime(){
+	return SimClock::Now();
+}
+
+UINT32 GetFPGATime(){
+	return (UINT32)(SimClock::Now() * 1.0e6);
+}
+
+//Timer
+
+Timer::Timer(){
+	m_startTime = SimClock::Now();
+	m_accumulatedTime = 0.0;
+	m_running = false;
+}
+
+double Timer::Get(){
+	if (m_running){
+		return m_accumulatedTime + (SimClock::Now() - m_startTime);
+	}
+	return m_accumulatedTime;
+}
+
+void Timer::Reset(){
+	m_accumulatedTime = 0.0;
+	m_startTime = SimClock::Now();
+}
+
+void Timer::Start(){
+	if (!m_running){
+		m_startTime = SimClock::Now();
+		m_running = true;
+	}
+}
+
+void Timer::Stop(){
+	if (m_running){
+		m_accumulatedTime = Get();
+		m_running = false;
+	}
+}
+
+bool Timer::HasPeriodPassed(double period){
+	if (Get() > period){
+		m_startTime += period;
+		return true;
+	}
+	return false;
+}
+
+double Timer::GetFPGATimestamp(){
+	return SimClock::Now();
+}
+
+//Notifier
+
+Notifier * Notifier::notifiers[Notifier::MAX_NOTIFIERS];
+int Notifier::num_notifiers = 0;
+
+Notifier::Notifier(TimerEventHandler handler, void *param){
+	m_handler = handler;
+	m_param = param;
+	m_expirationTime = 0.0;
+	m_period = 0.0;
+	m_periodic = false;
+	m_queued = false;
+	if (num_notifiers < MAX_NOTIFIERS){
+		notifiers[num_notifiers++] = this;
+	} else {
+		fprintf(stderr, "sim: too many Notifiers, this one will never fire\n");
+	}
+}
+
+Notifier::~Notifier(){
+	for (int i = 0; i < num_notifiers; i++){
+		if (notifiers[i] == this){
+			notifiers[i] = notifiers[--num_notifiers];
+			break;
+		}
+	}
+}
+
+void Notifier::StartSingle(double delay){
+	m_periodic = false;
+	m_period = delay;
+	m_expirationTime = SimClock::Now() + delay;
+	m_queued = true;
+}
+
+void Notifier::StartPeriodic(double period){
+	m_periodic = true;
+	m_period = period;
+	m_expirationTime = SimClock::Now() + period;
+	m_queued = true;
+}
+
+void Notifier::Stop(){
+	m_queued = false;
+}
+
+void Notifier::RunUntil(double t){
+	while (true){
+		Notifier * next = 0;
+		for (int i = 0; i < num_notifiers; i++){
+			Notifier * n = notifiers[i];
+			if (n->m_queued && n->m_expirationTime <= t
+					&& (next == 0 || n->m_expirationTime < next->m_expirationTime)){
+				next = n;
+			}
+		}
+		if (next == 0){
+			return;
+		}
+		SimClock::now = next->m_expirationTime;
+		if (next->m_periodic){
+			next->m_expirationTime += next->m_period;
+		} else {
+			next->m_queued = false;
+		}
+		next->m_handler(next->m_param);
+	}
+}
+
+//speed controllers
+
+PWMSpeedController::PWMSpeedController(UINT32 channel){
+	m_channel = channel;
+}
+
+void PWMSpeedController::Set(float speed, UINT8 syncGroup){
+	if (speed > 1.0f) speed = 1.0f;
+	if (speed < -1.0f) speed = -1.0f;
+	SimHAL::pwm[m_channel] = speed;
+}
+
+float PWMSpeedController::Get(){
+	return SimHAL::pwm[m_channel];
+}
+
+void PWMSpeedController::Disable(){
+	SimHAL::pwm[m_channel] = 0.0f;
+}
+
+void PWMSpeedController::PIDWrite(float output){
+	Set(output);
+}
+
+//digital IO
+
+DigitalInput * DigitalInput::interrupt_inputs[SimHAL::NUM_DIO + 1];
+
+DigitalInput::DigitalInput(UINT32 channel){
+	m_channel = channel;
+	m_interruptHandler = 0;
+	m_interruptParam = 0;
+	m_interruptsEnabled = false;
+	m_risingEdge = true;
+	m_fallingEdge = false;
+	m_interruptTimestamp = 0.0;
+}
+
+DigitalInput::~DigitalInput(){
+	CancelInterrupts();
+}
+
+UINT32 DigitalInput::Get(){
+	return SimHAL::dio[m_channel];
+}
+
+void DigitalInput::RequestInterrupts(tInterruptHandler handler, void *param){
+	m_interruptHandler = handler;
+	m_interruptParam = param;
+	interrupt_inputs[m_channel] = this;
+}
+
+void DigitalInput::CancelInterrupts(){
+	if (interrupt_inputs[m_channel] == this){
+		interrupt_inputs[m_channel] = 0;
+	}
+	m_interruptHandler = 0;
+	m_interruptsEnabled = false;
+}
+
+void DigitalInput::EnableInterrupts(){
+	m_interruptsEnabled = true;
+}
+
+void DigitalInput::DisableInterrupts(){
+	m_interruptsEnabled = false;
+}
+
+void DigitalInput::SetUpSourceEdge(bool risingEdge, bool fallingEdge){
+	m_risingEdge = risingEdge;
+	m_fallingEdge = fallingEdge;
+}
+
+double DigitalInput::ReadInterruptTimestamp(){
+	return m_interruptTimestamp;
+}
+
+void DigitalInput::SimEdge(UINT32 channel, bool rising){
+	DigitalInput * input = interrupt_inputs[channel];
+	if (input == 0 || !input->m_interruptsEnabled || input->m_interruptHandler == 0){
+		return;
+	}
+	if (rising ? input->m_risingEdge : input->m_fallingEdge){
+		input->m_interruptTimestamp = SimClock::Now();
+		input->m_interruptHandler(1 << channel, input->m_interruptParam);
+	}
+}
+
+DigitalOutput::DigitalOutput(UINT32 channel){
+	m_channel = channel;
+}
+
+void DigitalOutput::Set(UINT32 value){
+	SimHAL::dio[m_channel] = value;
+}
+
+//Encoder
+
+Encoder::Encoder(UINT32 aChannel, UINT32 bChannel, bool reverseDirection, EncodingType encodingType){
+	m_aChannel = aChannel;
+	m_reverseDirection = reverseDirection;
+	m_counting = false;
+	m_offset = SimHAL::encoder_count[aChannel];
+	m_stoppedCount = 0;
+	m_distancePerPulse = 1.0;
+	m_pidSource = kDistance;
+}
+
+void Encoder::Start(){
+	if (!m_counting){
+		//counts that came in while stopped are lost, like on the FPGA
+		m_offset = SimHAL::encoder_count[m_aChannel] - m_stoppedCount;
+		m_counting = true;
+	}
+}
+
+INT32 Encoder::GetRaw(){
+	if (!m_counting){
+		return m_stoppedCount;
+	}
+	INT32 count = SimHAL::encoder_count[m_aChannel] - m_offset;
+	return m_reverseDirection ? -count : count;
+}
+
+INT32 Encoder::Get(){
+	return GetRaw();
+}
+
+void Encoder::Reset(){
+	m_offset = SimHAL::encoder_count[m_aChannel];
+	m_stoppedCount = 0;
+}
+
+void Encoder::Stop(){
+	if (m_counting){
+		m_stoppedCount = GetRaw();
+		m_counting = false;
+	}
+}
+
+double Encoder::GetDistance(){
+	return Get() * m_distancePerPulse;
+}
+
+double Encoder::GetRate(){
+	if (!m_counting){
+		return 0.0;
+	}
+	double rate = SimHAL::encoder_rate[m_aChannel] * m_distancePerPulse;
+	return m_reverseDirection ? -rate : rate;
+}
+
+void Encoder::SetDistancePerPulse(double distancePerPulse){
+	m_distancePerPulse = distancePerPulse;
+}
+
+void Encoder::SetReverseDirection(bool reverseDirection){
+	m_reverseDirection = reverseDirection;
+}
+
+void Encoder::SetPIDSourceParameter(PIDSourceParameter pidSource){
+	m_pidSource = pidSource;
+}
+
+double Encoder::PIDGet(){
+	return m_pidSource == kRate ? GetRate() : GetDistance();
+}
+
+//pneumatics
+
+Solenoid::Solenoid(UINT32 channel){
+	m_channel = channel;
+}
+
+void Solenoid::Set(bool on){
+	SimHAL::solenoid[m_channel] = on;
+}
+
+bool Solenoid::Get(){
+	return SimHAL::solenoid[m_channel];
+}
+
+DoubleSolenoid::DoubleSolenoid(UINT32 forwardChannel, UINT32 reverseChannel){
+	m_forwardChannel = forwardChannel;
+	m_reverseChannel = reverseChannel;
+}
+
+void DoubleSolenoid::Set(Value value){
+	SimHAL::solenoid[m_forwardChannel] = value == kForward;
+	SimHAL::solenoid[m_reverseChannel] = value == kReverse;
+}
+
+DoubleSolenoid::Value DoubleSolenoid::Get(){
+	if (SimHAL::solenoid[m_forwardChannel]) return kForward;
+	if (SimHAL::solenoid[m_reverseChannel]) return kReverse;
+	return kOff;
+}
+
+Compressor::Compressor(UINT32 pressureSwitchChannel, UINT32 compressorRelayChannel){
+	m_pressureSwitchChannel = pressureSwitchChannel;
+	m_relayChannel = compressorRelayChannel;
+	m_enabled = false;
+}
+
+void Compressor::Start(){
+	m_enabled = true;
+	SimHAL::relay_forward[m_relayChannel] = true;
+}
+
+void Compressor::Stop(){
+	m_enabled = false;
+	SimHAL::relay_forward[m_relayChannel] = false;
+}
+
+bool Compressor::Enabled(){
+	return m_enabled;
+}
+
+UINT32 Compressor::GetPressureSwitchValue(){
+	return SimHAL::dio[m_pressureSwitchChannel];
+}
+
+//Task
+
+Task::Task(const char* name, FUNCPTR function, INT32 priority, UINT32 stackSize){
+	m_function = function;
+	memset(m_args, 0, sizeof(m_args));
+}
+
+bool Task::Start(UINT32 arg0, UINT32 arg1, UINT32 arg2, UINT32 arg3, UINT32 arg4,
+		UINT32 arg5, UINT32 arg6, UINT32 arg7, UINT32 arg8, UINT32 arg9){
+	UINT32 args[10] = {arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9};
+	memcpy(m_args, args, sizeof(m_args));
+	pthread_t thread;
+	if (pthread_create(&thread, NULL, Task::Run, this) != 0){
+		return false;
+	}
+	pthread_detach(thread);
+	return true;
+}
+
+void * Task::Run(void * task){
+	Task * self = (Task *)task;
+	UINT32 * a = self->m_args;
+	self->m_function(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9]);
+	return NULL;
+}
+
+//Ultrasonic
+
+bool Ultrasonic::m_automaticEnabled = false;
+
+Ultrasonic::Ultrasonic(UINT32 pingChannel, UINT32 echoChannel, DistanceUnit units){
+	Initialize(pingChannel, echoChannel);
+}
+
+Ultrasonic::Ultrasonic(DigitalOutput *pingChannel, DigitalInput *echoChannel, DistanceUnit units){
+	Initialize(pingChannel->GetChannel(), echoChannel->GetChannel());
+}
+
+void Ultrasonic::Initialize(UINT32 pingChannel, UINT32 echoChannel){
+	m_pingChannel = pingChannel;
+	m_echoChannel = echoChannel;
+	m_enabled = true;
+	m_echoReceived = false;
+	m_range = 0.0f;
+	m_echo = new Notifier(Ultrasonic::EchoReturned, this);
+	SimHAL::dio[m_echoChannel] = 0;
+}
+
+Ultrasonic::~Ultrasonic(){
+	delete m_echo;
+}
+
+void Ultrasonic::Ping(){
+	m_echoReceived = false;
+	m_echo->Stop();
+	SimHAL::SetDigitalInput(m_echoChannel, 1);
+	float range = SimHAL::ultrasonic_range[m_pingChannel];
+	if (range > 0.0f){
+		m_echo->StartSingle(2.0 * range / kSpeedOfSoundInchesPerSec);
+	}
+}
+
+void Ultrasonic::EchoReturned(void *ultrasonic){
+	Ultrasonic * us = (Ultrasonic *)ultrasonic;
+	us->m_range = SimHAL::ultrasonic_range[us->m_pingChannel];
+	us->m_echoReceived = true;
+	SimHAL::SetDigitalInput(us->m_echoChannel, 0);
+}
+
+bool Ultrasonic::IsRangeValid(){
+	if (!m_enabled){
+		return false;
+	}
+	if (m_automaticEnabled){
+		return SimHAL::ultrasonic_range[m_pingChannel] > 0.0f;
+	}
+	return m_echoReceived;
+}
+
+double Ultrasonic::GetRangeInches(){
+	if (!IsRangeValid()){
+		return 0.0;
+	}
+	return m_automaticEnabled ? SimHAL::ultrasonic_range[m_pingChannel] : m_range;
+}
+
+double Ultrasonic::GetRangeMM(){
+	return GetRangeInches() * 25.4;
+}
+
+void Ultrasonic::SetAutomaticMode(bool enabling){
+	m_automaticEnabled = enabling;
+}
+
+//PIDController
+
+PIDController::PIDController(float p, float i, float d, PIDSource *source, PIDOutput *output, float period){
+	m_P = p;
+	m_I = i;
+	m_D = d;
+	m_minimumOutput = -1.0f;
+	m_maximumOutput = 1.0f;
+	m_enabled = false;
+	m_prevError = 0.0f;
+	m_totalError = 0.0;
+	m_setpoint = 0.0f;
+	m_error = 0.0f;
+	m_result = 0.0f;
+	m_pidInput = source;
+	m_pidOutput = output;
+	m_controlLoop = new Notifier(PIDController::CallCalculate, this);
+	m_controlLoop->StartPeriodic(period);
+}
+
+PIDController::~PIDController(){
+	delete m_controlLoop;
+}
+
+void PIDController::CallCalculate(void *controller){
+	((PIDController *)controller)->Calculate();
+}
+
+void PIDController::Calculate(){
+	if (!m_enabled){
+		return;
+	}
+	float input = m_pidInput->PIDGet();
+	m_error = m_setpoint - input;
+	if (m_I != 0.0f){
+		double potentialIGain = (m_totalError + m_error) * m_I;
+		if (potentialIGain < m_maximumOutput && potentialIGain > m_minimumOutput){
+			m_totalError += m_error;
+		}
+	}
+	m_result = m_P * m_error + m_I * m_totalError + m_D * (m_error - m_prevError);
+	m_prevError = m_error;
+	if (m_result > m_maximumOutput) m_result = m_maximumOutput;
+	else if (m_result < m_minimumOutput) m_result = m_minimumOutput;
+	m_pidOutput->PIDWrite(m_result);
+}
+
+float PIDController::Get(){
+	return m_result;
+}
+
+void PIDController::SetSetpoint(float setpoint){
+	m_setpoint = setpoint;
+}
+
+float PIDController::GetSetpoint(){
+	return m_setpoint;
+}
+
+float PIDController::GetError(){
+	return m_setpoint - m_pidInput->PIDGet();
+}
+
+void PIDController::SetPID(float p, float i, float d){
+	m_P = p;
+	m_I = i;
+	m_D = d;
+}
+
+void PIDController::SetOutputRange(float minimumOutput, float maximumOutput){
+	m_minimumOutput = minimumOutput;
+	m_maximumOutput = maximumOutput;
+}
+
+void PIDController::Enable(){
+	m_enabled = true;
+}
+
+void PIDController::Disable(){
+	m_pidOutput->PIDWrite(0.0f);
+	m_enabled = false;
+}
+
+bool PIDController::IsEnabled(){
+	return m_enabled;
+}
+
+void PIDController::Reset(){
+	Disable();
+	m_prevError = 0.0f;
+	m_totalError = 0.0;
+	m_result = 0.0f;
+}
+
+//RobotDrive, same mixing as WPILib so the motor outputs match the robot
+
+RobotDrive::RobotDrive(SpeedController *frontLeftMotor, SpeedController *rearLeftMotor,
+		SpeedController *frontRightMotor, SpeedController *rearRightMotor){
+	m_frontLeftMotor = frontLeftMotor;
+	m_rearLeftMotor = rearLeftMotor;
+	m_frontRightMotor = frontRightMotor;
+	m_rearRightMotor = rearRightMotor;
+	for (int i = 0; i < 4; i++){
+		m_invertedMotors[i] = 1;
+	}
+	m_maxOutput = 1.0;
+	SetLeftRightMotorOutputs(0.0f, 0.0f);
+}
+
+float RobotDrive::Limit(float num){
+	if (num > 1.0f) return 1.0f;
+	if (num < -1.0f) return -1.0f;
+	return num;
+}
+
+void RobotDrive::ArcadeDrive(float moveValue, float rotateValue, bool squaredInputs){
+	float leftMotorOutput;
+	float rightMotorOutput;
+
+	moveValue = Limit(moveValue);
+	rotateValue = Limit(rotateValue);
+
+	if (squaredInputs){
+		moveValue = moveValue >= 0.0f ? moveValue * moveValue : -(moveValue * moveValue);
+		rotateValue = rotateValue >= 0.0f ? rotateValue * rotateValue : -(rotateValue * rotateValue);
+	}
+
+	if (moveValue > 0.0f){
+		if (rotateValue > 0.0f){
+			leftMotorOutput = moveValue - rotateValue;
+			rightMotorOutput = moveValue > rotateValue ? moveValue : rotateValue;
+		} else {
+			leftMotorOutput = moveValue > -rotateValue ? moveValue : -rotateValue;
+			rightMotorOutput = moveValue + rotateValue;
+		}
+	} else {
+		if (rotateValue > 0.0f){
+			leftMotorOutput = -(-moveValue > rotateValue ? -moveValue : rotateValue);
+			rightMotorOutput = moveValue + rotateValue;
+		} else {
+			leftMotorOutput = moveValue - rotateValue;
+			rightMotorOutput = -(-moveValue > -rotateValue ? -moveValue : -rotateValue);
+		}
+	}
+	SetLeftRightMotorOutputs(leftMotorOutput, rightMotorOutput);
+}
+
+void RobotDrive::TankDrive(float leftValue, float rightValue, bool squaredInputs){
+	leftValue = Limit(leftValue);
+	rightValue = Limit(rightValue);
+	if (squaredInputs){
+		leftValue = leftValue >= 0.0f ? leftValue * leftValue : -(leftValue * leftValue);
+		rightValue = rightValue >= 0.0f ? rightValue * rightValue : -(rightValue * rightValue);
+	}
+	SetLeftRightMotorOutputs(leftValue, rightValue);
+}
+
+void RobotDrive::SetLeftRightMotorOutputs(float leftOutput, float rightOutput){
+	m_frontLeftMotor->Set(Limit(leftOutput) * m_invertedMotors[kFrontLeftMotor] * m_maxOutput);
+	m_rearLeftMotor->Set(Limit(leftOutput) * m_invertedMotors[kRearLeftMotor] * m_maxOutput);
+	m_frontRightMotor->Set(-Limit(rightOutput) * m_invertedMotors[kFrontRightMotor] * m_maxOutput);
+	m_rearRightMotor->Set(-Limit(rightOutput) * m_invertedMotors[kRearRightMotor] * m_maxOutput);
+}
+
+void RobotDrive::SetInvertedMotor(MotorType motor, bool isInverted){
+	m_invertedMotors[motor] = isInverted ? -1 : 1;
+}
+
+//DriverStation
+
+DriverStation *DriverStation::GetInstance(){
+	static DriverStation instance;
+	return &instance;
+}
+
+float DriverStation::GetStickAxis(UINT32 stick, UINT32 axis){
+	if (stick < 1 || stick > (UINT32)SimHAL::NUM_STICKS || axis < 1 || axis > (UINT32)SimHAL::NUM_AXES){
+		return 0.0f;
+	}
+	return SimHAL::stick_axes[stick][axis];
+}
+
+short DriverStation::GetStickButtons(UINT32 stick){
+	if (stick < 1 || stick > (UINT32)SimHAL::NUM_STICKS){
+		return 0;
+	}
+	return (short)SimHAL::stick_buttons[stick];
+}
+
+DriverStation::Alliance DriverStation::GetAlliance(){
+	return SimHAL::blue_alliance ? kBlue : kRed;
+}
+
+bool DriverStation::IsEnabled(){
+	return SimHAL::mode != SimHAL::DISABLED;
+}
+
+bool DriverStation::IsDisabled(){
+	return SimHAL::mode == SimHAL::DISABLED;
+}
+
+bool DriverStation::IsAutonomous(){
+	return SimHAL::mode == SimHAL::AUTONOMOUS;
+}
+
+bool DriverStation::IsOperatorControl(){
+	return SimHAL::mode == SimHAL::TELEOP;
+}
+
+bool DriverStation::IsTest(){
+	return SimHAL::mode == SimHAL::TEST;
+}
+
+//DriverStationLCD
+
+DriverStationLCD::DriverStationLCD(){
+	Clear();
+}
+
+DriverStationLCD *DriverStationLCD::GetInstance(){
+	static DriverStationLCD instance;
+	return &instance;
+}
+
+void DriverStationLCD::UpdateLCD(){
+	memcpy(SimHAL::lcd, m_textBuffer, sizeof(m_textBuffer));
+}
+
+void DriverStationLCD::Printf(Line line, INT32 startingColumn, const char *writeFmt, ...){
+	char buffer[kLineLength + 1];
+	va_list args;
+	va_start(args, writeFmt);
+	INT32 length = vsnprintf(buffer, sizeof(buffer), writeFmt, args);
+	va_end(args);
+	if (startingColumn < 0 || startingColumn >= (INT32)kLineLength){
+		return;
+	}
+	if (length > (INT32)kLineLength - startingColumn){
+		length = kLineLength - startingColumn;
+	}
+	if (length > 0){
+		memcpy(m_textBuffer[line] + startingColumn, buffer, length);
+	}
+}
+
+void DriverStationLCD::PrintfLine(Line line, const char *writeFmt, ...){
+	char buffer[kLineLength + 1];
+	va_list args;
+	va_start(args, writeFmt);
+	INT32 length = vsnprintf(buffer, sizeof(buffer), writeFmt, args);
+	va_end(args);
+	if (length < 0){
+		length = 0;
+	} else if (length > (INT32)kLineLength){
+		length = kLineLength;
+	}
+	memset(m_textBuffer[line], ' ', kLineLength);
+	memcpy(m_textBuffer[line], buffer, length);
+	m_textBuffer[line][kLineLength] = '\0';
+}
+
+void DriverStationLCD::Clear(){
+	for (UINT32 i = 0; i < kNumLines; i++){
+		memset(m_textBuffer[i], ' ', kLineLength);
+		m_textBuffer[i][kLineLength] = '\0';
+	}
+}
+
+//Joystick
+
+Joystick::Joystick(UINT32 port){
+	m_ds = DriverStation::GetInstance();
+	m_port = port;
+}
+
+float Joystick::GetRawAxis(UINT32 axis){
+	return m_ds->GetStickAxis(m_port, axis);
+}
+
+bool Joystick::GetRawButton(UINT32 button){
+	return ((0x1 << (button - 1)) & m_ds->GetStickButtons(m_port)) != 0;
+}
+
+//RobotBase and IterativeRobot
+
+RobotBase::RobotBase(){
+	m_ds = DriverStation::GetInstance();
+}
+
+bool RobotBase::IsEnabled(){
+	return m_ds->IsEnabled();
+}
+
+bool RobotBase::IsDisabled(){
+	return m_ds->IsDisabled();
+}
+
+bool RobotBase::IsAutonomous(){
+	return m_ds->IsAutonomous();
+}
+
+bool RobotBase::IsOperatorControl(){
+	return m_ds->IsOperatorControl();
+}
+
+bool RobotBase::IsTest(){
+	return m_ds->IsTest();
+}
+
+IterativeRobot::IterativeRobot(){
+	m_period = kDefaultPeriod;
+	m_disabledInitialized = false;
+	m_autonomousInitialized = false;
+	m_teleopInitialized = false;
+	m_testInitialized = false;
+}
+
+double IterativeRobot::GetLoopsPerSec(){
+	//synchronized to the driver station, which sends packets at 50 Hz
+	if (m_period == kDefaultPeriod){
+		return 50.0;
+	}
+	return 1.0 / m_period;
+}
+
+void IterativeRobot::StartCompetition(){
+	RobotInit();
+}
+
+void IterativeRobot::LoopOnce(){
+	if (IsDisabled()){
+		if (!m_disabledInitialized){
+			DisabledInit();
+			m_disabledInitialized = true;
+			m_autonomousInitialized = false;
+			m_teleopInitialized = false;
+			m_testInitialized = false;
+		}
+		DisabledPeriodic();
+	} else if (IsTest()){
+		if (!m_testInitialized){
+			TestInit();
+			m_testInitialized = true;
+			m_disabledInitialized = false;
+			m_autonomousInitialized = false;
+			m_teleopInitialized = false;
+		}
+		TestPeriodic();
+	} else if (IsAutonomous()){
+		if (!m_autonomousInitialized){
+			AutonomousInit();
+			m_autonomousInitialized = true;
+			m_disabledInitialized = false;
+			m_teleopInitialized = false;
+			m_testInitialized = false;
+		}
+		AutonomousPeriodic();
+	} else {
+		if (!m_teleopInitialized){
+			TeleopInit();
+			m_teleopInitialized = true;
+			m_disabledInitialized = false;
+			m_autonomousInitialized = false;
+			m_testInitialized = false;
+		}
+		TeleopPeriodic();
+	}
+}
@@ -0,0 +1,428 @@
+#ifndef SIM_WPILIB_H_
+#define SIM_WPILIB_H_
+
+/*
+ * Host-side replacement for the parts of WPILib (2014, C++) the robot uses.
+ * Signatures match the real library, so the code in 2014robot/ compiles against this
+ * header unchanged. Behavior is reduced to what the simulation needs: outputs land in
+ * SimHAL, inputs come from SimHAL, and all time comes from SimClock.
+ */
+
+#include "vxWorks.h"
+#include "SimHAL.h"
+
+class Notifier;
+class Task;
+
+typedef void (*TimerEventHandler)(void *param);
+typedef void (*tInterruptHandler)(UINT32 interruptAssertedMask, void *param);
+
+double GetTime();
+UINT32 GetFPGATime(); //microseconds
+
+class Timer {
+public:
+	Timer();
+	virtual ~Timer() {}
+	double Get();
+	void Reset();
+	void Start();
+	void Stop();
+	bool HasPeriodPassed(double period);
+	static double GetFPGATimestamp();
+private:
+	double m_startTime;
+	double m_accumulatedTime;
+	bool m_running;
+};
+
+/*
+ * Runs a handler at a given time (or periodically) on the virtual clock.
+ * On the robot this is a separate FPGA-timer-driven task; here SimClock::Advance()
+ * fires handlers synchronously at their scheduled times.
+ */
+class Notifier {
+public:
+	Notifier(TimerEventHandler handler, void *param = 0);
+	virtual ~Notifier();
+	void StartSingle(double delay);
+	void StartPeriodic(double period);
+	void Stop();
+
+	//SimClock's hook: fires every handler due at or before time t, earliest first
+	static void RunUntil(double t);
+private:
+	static const int MAX_NOTIFIERS = 32;
+	static Notifier * notifiers[MAX_NOTIFIERS];
+	static int num_notifiers;
+
+	TimerEventHandler m_handler;
+	void * m_param;
+	double m_expirationTime;
+	double m_period;
+	bool m_periodic;
+	bool m_queued;
+};
+
+/*
+ * A vxWorks task. On the host this is a thread; priority and stack size are ignored,
+ * and it runs in real time, not on the virtual clock.
+ */
+class Task {
+public:
+	static const INT32 kDefaultPriority = 101;
+
+	Task(const char* name, FUNCPTR function, INT32 priority = kDefaultPriority, UINT32 stackSize = 20000);
+	virtual ~Task() {}
+	bool Start(UINT32 arg0 = 0, UINT32 arg1 = 0, UINT32 arg2 = 0, UINT32 arg3 = 0, UINT32 arg4 = 0,
+			UINT32 arg5 = 0, UINT32 arg6 = 0, UINT32 arg7 = 0, UINT32 arg8 = 0, UINT32 arg9 = 0);
+private:
+	FUNCPTR m_function;
+	UINT32 m_args[10];
+	static void * Run(void * task);
+};
+
+class PIDSource {
+public:
+	virtual ~PIDSource() {}
+	virtual double PIDGet() = 0;
+};
+
+class PIDOutput {
+public:
+	virtual ~PIDOutput() {}
+	virtual void PIDWrite(float output) = 0;
+};
+
+class SpeedController : public PIDOutput {
+public:
+	virtual ~SpeedController() {}
+	virtual void Set(float speed, UINT8 syncGroup = 0) = 0;
+	virtual float Get() = 0;
+	virtual void Disable() = 0;
+};
+
+class PWMSpeedController : public SpeedController {
+public:
+	explicit PWMSpeedController(UINT32 channel);
+	virtual void Set(float speed, UINT8 syncGroup = 0);
+	virtual float Get();
+	virtual void Disable();
+	virtual void PIDWrite(float output);
+	UINT32 GetChannel() { return m_channel; }
+private:
+	UINT32 m_channel;
+};
+
+class Victor : public PWMSpeedController {
+public:
+	explicit Victor(UINT32 channel) : PWMSpeedController(channel) {}
+};
+
+class Talon : public PWMSpeedController {
+public:
+	explicit Talon(UINT32 channel) : PWMSpeedController(channel) {}
+};
+
+/*
+ * Interrupts are dispatched synchronously by SimHAL::SetDigitalInput() when it changes
+ * a channel, at the current virtual time; only one DigitalInput per channel gets them.
+ */
+class DigitalInput {
+public:
+	explicit DigitalInput(UINT32 channel);
+	virtual ~DigitalInput();
+	UINT32 Get();
+	UINT32 GetChannel() { return m_channel; }
+
+	void RequestInterrupts(tInterruptHandler handler, void *param);
+	void CancelInterrupts();
+	void EnableInterrupts();
+	void DisableInterrupts();
+	void SetUpSourceEdge(bool risingEdge, bool fallingEdge);
+	double ReadInterruptTimestamp();
+
+	//SimHAL::SetDigitalInput()'s hook, called after the channel changed value
+	static void SimEdge(UINT32 channel, bool rising);
+private:
+	static DigitalInput * interrupt_inputs[SimHAL::NUM_DIO + 1];
+
+	UINT32 m_channel;
+	tInterruptHandler m_interruptHandler;
+	void * m_interruptParam;
+	bool m_interruptsEnabled;
+	bool m_risingEdge;
+	bool m_fallingEdge;
+	double m_interruptTimestamp;
+};
+
+class DigitalOutput {
+public:
+	explicit DigitalOutput(UINT32 channel);
+	virtual ~DigitalOutput() {}
+	void Set(UINT32 value);
+	UINT32 GetChannel() { return m_channel; }
+private:
+	UINT32 m_channel;
+};
+
+class Encoder : public PIDSource {
+public:
+	typedef enum {k1X, k2X, k4X} EncodingType;
+	typedef enum {kDistance, kRate} PIDSourceParameter;
+
+	Encoder(UINT32 aChannel, UINT32 bChannel, bool reverseDirection = false, EncodingType encodingType = k4X);
+	virtual ~Encoder() {}
+	void Start();
+	INT32 Get();
+	INT32 GetRaw();
+	void Reset();
+	void Stop();
+	double GetDistance();
+	double GetRate();
+	void SetDistancePerPulse(double distancePerPulse);
+	void SetReverseDirection(bool reverseDirection);
+	void SetPIDSourceParameter(PIDSourceParameter pidSource);
+	virtual double PIDGet();
+private:
+	UINT32 m_aChannel;
+	bool m_reverseDirection;
+	bool m_counting;
+	INT32 m_offset;
+	INT32 m_stoppedCount;
+	double m_distancePerPulse;
+	PIDSourceParameter m_pidSource;
+};
+
+class Solenoid {
+public:
+	explicit Solenoid(UINT32 channel);
+	virtual ~Solenoid() {}
+	virtual void Set(bool on);
+	virtual bool Get();
+private:
+	UINT32 m_channel;
+};
+
+class DoubleSolenoid {
+public:
+	typedef enum {kOff, kForward, kReverse} Value;
+
+	DoubleSolenoid(UINT32 forwardChannel, UINT32 reverseChannel);
+	virtual ~DoubleSolenoid() {}
+	virtual void Set(Value value);
+	virtual Value Get();
+private:
+	UINT32 m_forwardChannel;
+	UINT32 m_reverseChannel;
+};
+
+class Compressor {
+public:
+	Compressor(UINT32 pressureSwitchChannel, UINT32 compressorRelayChannel);
+	virtual ~Compressor() {}
+	void Start();
+	void Stop();
+	bool Enabled();
+	UINT32 GetPressureSwitchValue();
+private:
+	UINT32 m_pressureSwitchChannel;
+	UINT32 m_relayChannel;
+	bool m_enabled;
+};
+
+/*
+ * Ultrasonic rangefinder (Vex style ping/echo).
+ * Ping() raises the echo line, and it drops again after the round-trip time for
+ * SimHAL::ultrasonic_range at the speed of sound (never, if the range is 0), so
+ * interrupts on the echo input fire when they would on the robot.
+ * In automatic mode every enabled sensor always has a valid range.
+ */
+class Ultrasonic {
+public:
+	typedef enum {kInches = 0, kMilliMeters = 1} DistanceUnit;
+
+	Ultrasonic(UINT32 pingChannel, UINT32 echoChannel, DistanceUnit units = kInches);
+	Ultrasonic(DigitalOutput *pingChannel, DigitalInput *echoChannel, DistanceUnit units = kInches);
+	virtual ~Ultrasonic();
+	void Ping();
+	bool IsRangeValid();
+	double GetRangeInches();
+	double GetRangeMM();
+	bool IsEnabled() { return m_enabled; }
+	void SetEnabled(bool enable) { m_enabled = enable; }
+	static void SetAutomaticMode(bool enabling);
+private:
+	static const double kSpeedOfSoundInchesPerSec = 1130.0 * 12.0;
+	static bool m_automaticEnabled;
+
+	void Initialize(UINT32 pingChannel, UINT32 echoChannel);
+	static void EchoReturned(void *ultrasonic);
+
+	UINT32 m_pingChannel;
+	UINT32 m_echoChannel;
+	bool m_enabled;
+	bool m_echoReceived;
+	float m_range;
+	Notifier *m_echo;
+};
+
+class PIDController {
+public:
+	PIDController(float p, float i, float d, PIDSource *source, PIDOutput *output, float period = 0.05);
+	virtual ~PIDController();
+	float Get();
+	void SetSetpoint(float setpoint);
+	float GetSetpoint();
+	float GetError();
+	void SetPID(float p, float i, float d);
+	void SetOutputRange(float minimumOutput, float maximumOutput);
+	void Enable();
+	void Disable();
+	bool IsEnabled();
+	void Reset();
+private:
+	static void CallCalculate(void *controller);
+	void Calculate();
+
+	float m_P, m_I, m_D;
+	float m_minimumOutput, m_maximumOutput;
+	bool m_enabled;
+	float m_prevError;
+	double m_totalError;
+	float m_setpoint;
+	float m_error;
+	float m_result;
+	PIDSource *m_pidInput;
+	PIDOutput *m_pidOutput;
+	Notifier *m_controlLoop;
+};
+
+class RobotDrive {
+public:
+	typedef enum {kFrontLeftMotor = 0, kFrontRightMotor = 1, kRearLeftMotor = 2, kRearRightMotor = 3} MotorType;
+
+	RobotDrive(SpeedController *frontLeftMotor, SpeedController *rearLeftMotor,
+			SpeedController *frontRightMotor, SpeedController *rearRightMotor);
+	virtual ~RobotDrive() {}
+	void ArcadeDrive(float moveValue, float rotateValue, bool squaredInputs = true);
+	void TankDrive(float leftValue, float rightValue, bool squaredInputs = true);
+	virtual void SetLeftRightMotorOutputs(float leftOutput, float rightOutput);
+	void SetInvertedMotor(MotorType motor, bool isInverted);
+	void SetMaxOutput(double maxOutput) { m_maxOutput = maxOutput; }
+private:
+	static float Limit(float num);
+
+	int m_invertedMotors[4];
+	double m_maxOutput;
+	SpeedController *m_frontLeftMotor;
+	SpeedController *m_frontRightMotor;
+	SpeedController *m_rearLeftMotor;
+	SpeedController *m_rearRightMotor;
+};
+
+class DriverStation {
+public:
+	typedef enum {kRed, kBlue, kInvalid} Alliance;
+
+	static DriverStation *GetInstance();
+	float GetStickAxis(UINT32 stick, UINT32 axis);
+	short GetStickButtons(UINT32 stick);
+	Alliance GetAlliance();
+	bool IsEnabled();
+	bool IsDisabled();
+	bool IsAutonomous();
+	bool IsOperatorControl();
+	bool IsTest();
+private:
+	DriverStation() {}
+};
+
+class DriverStationLCD {
+public:
+	static const UINT32 kLineLength = SimHAL::LCD_LINE_LENGTH;
+	static const UINT32 kNumLines = SimHAL::LCD_LINES;
+	typedef enum {kMain_Line6 = 0, kUser_Line1 = 0, kUser_Line2 = 1, kUser_Line3 = 2,
+		kUser_Line4 = 3, kUser_Line5 = 4, kUser_Line6 = 5} Line;
+
+	static DriverStationLCD *GetInstance();
+	void UpdateLCD();
+	void Printf(Line line, INT32 startingColumn, const char *writeFmt, ...);
+	void PrintfLine(Line line, const char *writeFmt, ...);
+	void Clear();
+private:
+	DriverStationLCD();
+	char m_textBuffer[kNumLines][kLineLength + 1];
+};
+
+class Joystick {
+public:
+	explicit Joystick(UINT32 port);
+	virtual ~Joystick() {}
+	virtual float GetRawAxis(UINT32 axis);
+	virtual bool GetRawButton(UINT32 button);
+private:
+	DriverStation *m_ds;
+	UINT32 m_port;
+};
+
+class RobotBase {
+public:
+	virtual ~RobotBase() {}
+	bool IsEnabled();
+	bool IsDisabled();
+	bool IsAutonomous();
+	bool IsOperatorControl();
+	bool IsTest();
+	virtual void StartCompetition() = 0;
+protected:
+	RobotBase();
+	DriverStation *m_ds;
+};
+
+/*
+ * Same mode dispatch as the real IterativeRobot, split so the simulation can call it once per
+ * driver station packet: StartCompetition() runs RobotInit(), then LoopOnce() runs the Init
+ * function on a mode change followed by that mode's Periodic function.
+ */
+class IterativeRobot : public RobotBase {
+public:
+	static const double kDefaultPeriod = 0.0;
+
+	virtual void StartCompetition();
+	void LoopOnce();
+
+	virtual void RobotInit() {}
+	virtual void DisabledInit() {}
+	virtual void AutonomousInit() {}
+	virtual void TeleopInit() {}
+	virtual void TestInit() {}
+
+	virtual void DisabledPeriodic() {}
+	virtual void AutonomousPeriodic() {}
+	virtual void TeleopPeriodic() {}
+	virtual void TestPeriodic() {}
+
+	void SetPeriod(double period) { m_period = period; }
+	double GetPeriod() { return m_period; }
+	double GetLoopsPerSec();
+protected:
+	IterativeRobot();
+private:
+	double m_period;
+	bool m_disabledInitialized;
+	bool m_autonomousInitialized;
+	bool m_teleopInitialized;
+	bool m_testInitialized;
+};
+
+//the simulation's main() gets the robot from here, the same hook the cRIO startup code uses
+RobotBase *FRC_userClassFactory();
+
+#define START_ROBOT_CLASS(_ClassName_) \
+	RobotBase *FRC_userClassFactory() \
+	{ \
+		return new _ClassName_(); \
+	}
+
+#endif
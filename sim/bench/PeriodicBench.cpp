@@ -0,0 +1,519 @@
+/*
+ * Times the robot's periodic entry points against the simulated HAL.
+ * Each benchmark runs in its own child process, so every one starts from a fresh
+ * SimHAL and none of them see another's Notifiers still running. Inputs come from a
+ * trace: a telemetry log the robot recorded (telemetry.log, see TelemetryFormat.h),
+ * or a built-in 20 second script like the simulator's drivers. The robot's telemetry
+ * recorder is set to discard, so a benchmark writes no files (least of all the trace)
+ * and has no flush task writing to disk while it's timed.
+ * For each it reports ns per call (mean, p50, p99), user-space instructions per call
+ * (when the kernel lets us count them) and operator new calls per call.
+ * With -save it writes the results as a baseline; with -compare it reports the change
+ * against one and exits with 2 if anything got slower by more than the threshold.
+ *
+ *     g++ -std=gnu++98 -O2 -pthread -Isim -I2014robot sim/bench/PeriodicBench.cpp sim/SimHAL.cpp \
+ *         sim/WPILib.cpp sim/semLib.cpp 2014robot/?*.cpp -o periodicbench
+ *     ./periodicbench [-trace telemetry.log] [-n calls] [-r rounds] [-save file] [-compare file] [-threshold 0.1]
+ */
+#include "Arm.h"
+#include "Winch.h"
+#include "Rangefinder.h"
+#include "Gamepad.h"
+#include "TelemetryRecorder.h"
+#include "TelemetryFormat.h"
+#include "LoopProfiler.h"
+#include <linux/perf_event.h>
+#include <math.h>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+//channels the trace drives; these match AerialAssistRobot.h
+static const int PILOT = 1;
+static const int COPILOT = 2;
+static const int ARM_FLOOR_SWITCH_DIO = 5;
+static const int ARM_TOP_SWITCH_DIO = 7;
+static const int ARM_LINE_BREAK_DIO = 9;
+static const int WINCH_MAX_LIMIT_DIO = 4;
+static const int PRESSURE_SWITCH_DIO = 6;
+static const int ARM_ENCODER_A_CHANNEL = 1;
+static const int WINCH_ENCODER_A_CHANNEL = 5;
+static const int RANGE_FINDER_PING_CHANNEL_DIO = 13;
+static const int RANGE_FINDER_ECHO_CHANNEL_DIO = 14;
+
+static const double PACKET_PERIOD = 0.02;
+static const int AUTONOMOUS_CYCLES = 500; //10 seconds, then start the routine again
+static const int MAX_BENCHMARKS = 16;
+
+//every operator new in the process; the children only count their own
+static unsigned long allocations = 0;
+
+void * operator new(size_t size) throw(std::bad_alloc) {
+	allocations++;
+	void * p = malloc(size ? size : 1);
+	if (p == NULL) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void * operator new[](size_t size) throw(std::bad_alloc) {
+	return operator new(size);
+}
+
+//out of line, or gcc sees the free() meet the malloc() above and complains
+__attribute__((noinline)) void operator delete(void * p) throw() {
+	free(p);
+}
+
+void operator delete[](void * p) throw() {
+	free(p);
+}
+
+static TelemetryFormat::record * trace = NULL;
+static int trace_length = 0;
+
+static bool load_trace(const char * path) {
+	FILE * f = fopen(path, "rb");
+	if (f == NULL) {
+		perror(path);
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	UINT8 * data = (UINT8 *)malloc(size);
+	if (fread(data, 1, size, f) != (size_t)size || size < (long)sizeof(TelemetryFormat::log_header)) {
+		fprintf(stderr, "%s: too short\n", path);
+		return false;
+	}
+	fclose(f);
+
+	int capacity = 1024;
+	trace = (TelemetryFormat::record *)malloc(capacity * sizeof(TelemetryFormat::record));
+	TelemetryFormat::RecordDecoder decoder;
+	const UINT8 * p = data + sizeof(TelemetryFormat::log_header);
+	const UINT8 * end = data + size;
+	int used;
+	while (p < end && (used = decoder.decode(p, end, trace[trace_length])) > 0) {
+		p += used;
+		if (++trace_length == capacity) {
+			capacity *= 2;
+			trace = (TelemetryFormat::record *)realloc(trace, capacity * sizeof(TelemetryFormat::record));
+		}
+	}
+	free(data);
+	return trace_length > 0;
+}
+
+static INT8 pack(double v) {
+	return TelemetryRecorder::pack_output((float)v);
+}
+
+//the same 20 second loop the simulator's drivers run
+static void make_script_trace() {
+	trace_length = (int)(20.0 / PACKET_PERIOD);
+	trace = (TelemetryFormat::record *)calloc(trace_length, sizeof(TelemetryFormat::record));
+	for (int i = 0; i < trace_length; i++) {
+		double t = i * PACKET_PERIOD;
+		TelemetryFormat::record &r = trace[i];
+		r.pilot_axes[1] = pack(-0.8 * sin(t * 0.5));
+		r.pilot_axes[2] = pack(0.3 * sin(t * 0.13));
+		r.copilot_buttons = (t < 8.0) << 2 | (t > 9.0 && t < 10.0) << 0 | (t > 12.0 && t < 12.1) << 1;
+		r.switches = 0x1F; //pull-ups: nothing pressed, no ball
+		r.range = 120.0f;
+	}
+}
+
+//puts one trace record's inputs into the simulated HAL
+static void apply(const TelemetryFormat::record &r) {
+	for (int i = 0; i < 4; i++) {
+		SimHAL::stick_axes[PILOT][i + 1] = r.pilot_axes[i] / 127.0f;
+		SimHAL::stick_axes[COPILOT][i + 1] = r.copilot_axes[i] / 127.0f;
+	}
+	SimHAL::stick_buttons[PILOT] = r.pilot_buttons;
+	SimHAL::stick_buttons[COPILOT] = r.copilot_buttons;
+	SimHAL::SetDigitalInput(ARM_FLOOR_SWITCH_DIO, r.switches & 1);
+	SimHAL::SetDigitalInput(ARM_TOP_SWITCH_DIO, (r.switches >> 1) & 1);
+	SimHAL::SetDigitalInput(ARM_LINE_BREAK_DIO, (r.switches >> 2) & 1);
+	SimHAL::SetDigitalInput(WINCH_MAX_LIMIT_DIO, (r.switches >> 3) & 1);
+	SimHAL::SetDigitalInput(PRESSURE_SWITCH_DIO, (r.switches >> 4) & 1);
+	SimHAL::encoder_count[ARM_ENCODER_A_CHANNEL] = r.arm_encoder;
+	SimHAL::encoder_count[WINCH_ENCODER_A_CHANNEL] = r.winch_encoder;
+	SimHAL::ultrasonic_range[RANGE_FINDER_PING_CHANNEL_DIO] = r.range;
+}
+
+static double now_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1.0e9 + ts.tv_nsec;
+}
+
+//user-space instructions retired, through perf; -1 if the kernel won't let us
+static int open_instruction_counter() {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/*
+ * One benchmark: setup() builds what it needs (after the HAL is reset), prepare(i) does
+ * whatever has to happen before call i and isn't being measured, call() is measured
+ */
+class Benchmark {
+public:
+	const char * name;
+	Benchmark(const char * n) { name = n; }
+	virtual ~Benchmark() {}
+	virtual void setup() = 0;
+	virtual void prepare(int i) {}
+	virtual void call() = 0;
+};
+
+typedef struct {
+	char name[32];
+	double mean_ns;
+	double p50_ns;
+	double p99_ns;
+	double instructions; //per call, or -1
+	double allocations;  //per call
+} result;
+
+/*
+ * Makes rounds passes of calls calls each. The mean reported is the best round's, since
+ * anything else on the machine only ever makes a round slower; the percentiles and
+ * counts cover every call.
+ */
+static void run(Benchmark * b, int calls, int rounds, result &out) {
+	SimHAL::Reset();
+	SimClock::Reset();
+	b->setup();
+
+	LatencyHistogram histogram;
+	double best = 0.0;
+	int counter = open_instruction_counter();
+	long long instructions = 0;
+	unsigned long allocations_before = allocations;
+	for (int round = 0; round < rounds; round++) {
+		double total = 0.0;
+		for (int i = 0; i < calls; i++) {
+			apply(trace[i % trace_length]);
+			SimClock::Advance(PACKET_PERIOD);
+			b->prepare(i);
+			if (counter >= 0) {
+				ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+			}
+			double start = now_ns();
+			b->call();
+			double elapsed = now_ns() - start;
+			if (counter >= 0) {
+				ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+			}
+			total += elapsed;
+			histogram.record((UINT32)elapsed);
+		}
+		if (round == 0 || total < best) {
+			best = total;
+		}
+	}
+	if (counter >= 0) {
+		if (read(counter, &instructions, sizeof(instructions)) != sizeof(instructions)) {
+			instructions = -1;
+		}
+		close(counter);
+	}
+	double all_calls = (double)calls * rounds;
+	strncpy(out.name, b->name, sizeof(out.name) - 1);
+	out.name[sizeof(out.name) - 1] = '\0';
+	out.mean_ns = best / calls;
+	out.p50_ns = histogram.percentile(0.5f);
+	out.p99_ns = histogram.percentile(0.99f);
+	out.instructions = counter >= 0 && instructions >= 0 ? instructions / all_calls : -1.0;
+	out.allocations = (allocations - allocations_before) / all_calls;
+}
+
+static IterativeRobot * make_robot() {
+	TelemetryRecorder::set_discarding(true);
+	IterativeRobot * robot = (IterativeRobot *)FRC_userClassFactory();
+	robot->StartCompetition();
+	return robot;
+}
+
+class TeleopBench : public Benchmark {
+public:
+	TeleopBench() : Benchmark("TeleopPeriodic") {}
+	IterativeRobot * robot;
+	void setup() { SimHAL::mode = SimHAL::TELEOP; robot = make_robot(); robot->TeleopInit(); }
+	void call() { robot->TeleopPeriodic(); }
+};
+
+class TestBench : public Benchmark {
+public:
+	TestBench() : Benchmark("TestPeriodic (safety)") {}
+	IterativeRobot * robot;
+	void setup() { SimHAL::mode = SimHAL::TEST; robot = make_robot(); robot->TestInit(); }
+	void call() { robot->TestPeriodic(); }
+};
+
+//picks routine n the way the copilot does: pressing button n + 1 while disabled
+class AutonomousBench : public Benchmark {
+public:
+	AutonomousBench(const char * name, int n) : Benchmark(name) { routine = n; }
+	IterativeRobot * robot;
+	int routine;
+	void setup() {
+		robot = make_robot();
+		SimHAL::stick_buttons[COPILOT] = 0;
+		robot->DisabledPeriodic();
+		SimHAL::stick_buttons[COPILOT] = 1 << routine;
+		robot->DisabledPeriodic();
+		SimHAL::mode = SimHAL::AUTONOMOUS;
+	}
+	void prepare(int i) {
+		if (i % AUTONOMOUS_CYCLES == 0) {
+			robot->AutonomousInit();
+		}
+	}
+	void call() { robot->AutonomousPeriodic(); }
+};
+
+//the subsystems read a latched sensor frame and stage some outputs; their benchmarks
+//include committing the outputs, but not the latch, which a whole scheduler tick shares
+class ArmBench : public Benchmark {
+public:
+	ArmBench() : Benchmark("Arm::update") {}
+	Arm * arm;
+	SensorFrame * sensors;
+	OutputFrame * outputs;
+	void setup() {
+		sensors = new SensorFrame();
+		outputs = new OutputFrame();
+		arm = new Arm(new Victor(1), new Victor(2), new Encoder(ARM_ENCODER_A_CHANNEL, 2),
+				new DigitalInput(ARM_FLOOR_SWITCH_DIO), new DigitalInput(ARM_TOP_SWITCH_DIO),
+				new DigitalInput(ARM_LINE_BREAK_DIO), sensors, outputs);
+	}
+	void prepare(int i) {
+		sensors->latch();
+		arm->begin_cycle();
+		arm->load_sequence(); //so it cycles through lowering, waiting and raising with the trace
+	}
+	void call() { arm->update(); outputs->commit(); }
+};
+
+class WinchBench : public Benchmark {
+public:
+	WinchBench() : Benchmark("Winch::update") {}
+	Winch * winch;
+	SensorFrame * sensors;
+	OutputFrame * outputs;
+	void setup() {
+		sensors = new SensorFrame();
+		outputs = new OutputFrame();
+		winch = new Winch(new Victor(9), new Solenoid(2), new Encoder(WINCH_ENCODER_A_CHANNEL, 8),
+				new DigitalInput(WINCH_MAX_LIMIT_DIO), sensors, outputs);
+	}
+	void prepare(int i) {
+		sensors->latch();
+		if (i % 250 == 0) {
+			winch->fire(); //fire, post-fire and wind back every 5 seconds
+		}
+	}
+	void call() { winch->update(); outputs->commit(); }
+};
+
+class RangefinderBench : public Benchmark {
+public:
+	RangefinderBench() : Benchmark("Rangefinder::update") {}
+	Rangefinder * rangefinder;
+	void setup() {
+		DigitalInput * echo = new DigitalInput(RANGE_FINDER_ECHO_CHANNEL_DIO);
+		Ultrasonic * ultrasonic = new Ultrasonic(new DigitalOutput(RANGE_FINDER_PING_CHANNEL_DIO), echo);
+		RangingScheduler * ranging = new RangingScheduler();
+		rangefinder = new Rangefinder(ranging, ranging->add_sensor(ultrasonic, echo));
+		ranging->start();
+	}
+	void call() { rangefinder->update(); }
+};
+
+//what TeleopPeriodic asks of the pilot's gamepad each cycle
+class GamepadBench : public Benchmark {
+public:
+	GamepadBench() : Benchmark("Gamepad accessors") {}
+	Gamepad * pad;
+	volatile float sink;
+	void setup() { pad = new Gamepad(PILOT); pad->SetSnapshotMode(true); }
+	void call() {
+		pad->Latch();
+		float total = pad->GetLeftY() + pad->GetRightX();
+		for (unsigned b = 5; b <= 8; b++) {
+			total += pad->GetNumberedButton(b);
+		}
+		total += pad->GetNumberedButtonPressed(1);
+		sink = total;
+	}
+};
+
+static int load_baseline(const char * path, result * baseline) {
+	FILE * f = fopen(path, "r");
+	if (f == NULL) {
+		perror(path);
+		return -1;
+	}
+	int n = 0;
+	char line[256];
+	while (n < MAX_BENCHMARKS && fgets(line, sizeof(line), f) != NULL) {
+		result &r = baseline[n];
+		//name is tab separated from the numbers since it has spaces in it
+		char * tab = strchr(line, '\t');
+		if (line[0] == '#' || tab == NULL) {
+			continue;
+		}
+		*tab = '\0';
+		strncpy(r.name, line, sizeof(r.name) - 1);
+		r.name[sizeof(r.name) - 1] = '\0';
+		if (sscanf(tab + 1, "%lf %lf %lf %lf %lf", &r.mean_ns, &r.p50_ns, &r.p99_ns,
+				&r.instructions, &r.allocations) == 5) {
+			n++;
+		}
+	}
+	fclose(f);
+	return n;
+}
+
+int main(int argc, char **argv) {
+	int calls = 10000;
+	int rounds = 5;
+	const char * trace_path = NULL;
+	const char * save_path = NULL;
+	const char * compare_path = NULL;
+	double threshold = 0.10;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			calls = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+			rounds = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-trace") == 0 && i + 1 < argc) {
+			trace_path = argv[++i];
+		} else if (strcmp(argv[i], "-save") == 0 && i + 1 < argc) {
+			save_path = argv[++i];
+		} else if (strcmp(argv[i], "-compare") == 0 && i + 1 < argc) {
+			compare_path = argv[++i];
+		} else if (strcmp(argv[i], "-threshold") == 0 && i + 1 < argc) {
+			threshold = atof(argv[++i]);
+		} else {
+			fprintf(stderr, "usage: %s [-trace telemetry.log] [-n calls] [-r rounds] [-save file]"
+					" [-compare file]"
+					" [-threshold fraction]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (trace_path != NULL) {
+		if (!load_trace(trace_path)) {
+			return 1;
+		}
+		printf("trace: %s, %d cycles\n", trace_path, trace_length);
+	} else {
+		make_script_trace();
+		printf("trace: built-in driver script, %d cycles\n", trace_length);
+	}
+
+	Benchmark * benchmarks[] = {
+		new TeleopBench(), new TestBench(),
+		new AutonomousBench("AutonomousPeriodic (two ball)", 0),
+		new AutonomousBench("AutonomousPeriodic (main)", 1),
+		new AutonomousBench("AutonomousPeriodic (drive)", 2),
+		new ArmBench(), new WinchBench(), new RangefinderBench(), new GamepadBench()
+	};
+	int num_benchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
+	result results[MAX_BENCHMARKS];
+
+	for (int b = 0; b < num_benchmarks; b++) {
+		int pipe_fds[2];
+		if (pipe(pipe_fds) != 0) {
+			perror("pipe");
+			return 1;
+		}
+		fflush(stdout);
+		pid_t child = fork();
+		if (child == 0) {
+			close(pipe_fds[0]);
+			//the robot code prints; keep it out of the report
+			if (freopen("/dev/null", "w", stdout) == NULL) {
+				_exit(1);
+			}
+			result r;
+			run(benchmarks[b], calls, rounds, r);
+			_exit(write(pipe_fds[1], &r, sizeof(r)) == sizeof(r) ? 0 : 1);
+		}
+		close(pipe_fds[1]);
+		bool ok = read(pipe_fds[0], &results[b], sizeof(result)) == sizeof(result);
+		close(pipe_fds[0]);
+		int status;
+		waitpid(child, &status, 0);
+		if (!ok) {
+			fprintf(stderr, "%s: benchmark process failed\n", benchmarks[b]->name);
+			return 1;
+		}
+	}
+
+	result baseline[MAX_BENCHMARKS];
+	int num_baseline = 0;
+	if (compare_path != NULL && (num_baseline = load_baseline(compare_path, baseline)) < 0) {
+		return 1;
+	}
+
+	int regressions = 0;
+	printf("%-30s %10s %10s %10s %12s %8s%s\n", "", "ns/call", "p50 ns", "p99 ns", "instructions",
+			"allocs", num_baseline ? "   vs baseline" : "");
+	for (int b = 0; b < num_benchmarks; b++) {
+		result &r = results[b];
+		printf("%-30s %10.1f %10.0f %10.0f", r.name, r.mean_ns, r.p50_ns, r.p99_ns);
+		if (r.instructions >= 0.0) {
+			printf(" %12.0f", r.instructions);
+		} else {
+			printf(" %12s", "-");
+		}
+		printf(" %8.2f", r.allocations);
+		for (int i = 0; i < num_baseline; i++) {
+			if (strcmp(baseline[i].name, r.name) == 0) {
+				double change = r.mean_ns / baseline[i].mean_ns - 1.0;
+				bool regressed = change > threshold || r.allocations > baseline[i].allocations;
+				printf("   %+6.1f%%%s", change * 100.0, regressed ? "  REGRESSION" : "");
+				regressions += regressed;
+			}
+		}
+		printf("\n");
+	}
+	if (results[0].instructions < 0.0) {
+		printf("(instruction counts need perf events, which this kernel doesn't allow)\n");
+	}
+
+	if (save_path != NULL) {
+		FILE * f = fopen(save_path, "w");
+		if (f == NULL) {
+			perror(save_path);
+			return 1;
+		}
+		fprintf(f, "#name\tmean_ns p50_ns p99_ns instructions allocations\n");
+		for (int b = 0; b < num_benchmarks; b++) {
+			result &r = results[b];
+			fprintf(f, "%s\t%.1f %.0f %.0f %.0f %.4f\n", r.name, r.mean_ns, r.p50_ns, r.p99_ns,
+					r.instructions, r.allocations);
+		}
+		fclose(f);
+		printf("saved baseline to %s\n", save_path);
+	}
+	return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * Compares the winch shot table against evaluating the physics directly.
+ *
+ *     g++ -std=gnu++98 -O2 -pthread -Isim -I2014robot sim/bench/ShotTableBench.cpp \
+ *         sim/SimHAL.cpp sim/WPILib.cpp sim/semLib.cpp 2014robot/?*.cpp -o shottablebench
+ */
+#include "Winch.h"
+#include "CycleCounter.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int LOOKUPS = 1000000;
+static const int TABLE_SIZE = 256;
+static const float MAX_ANGLE = 1.5f; //radians of pull-back
+
+static float random_between(float min, float max){
+	return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+static float volatile sink; //so the compiler can't throw the work away
+
+int main(){
+	float * inputs = new float[LOOKUPS];
+
+	//distance -> steps, the table the winch uses
+	InterpolatedTable<TABLE_SIZE> distance_table;
+	double start = CycleCounter::reference_seconds();
+	distance_table.build(Winch::computeEncoderStepsFromDistance, 0.0f, 63.75f);
+	double build_time = CycleCounter::reference_seconds() - start;
+	printf("distance table: %d points built in %.1f us, %d of %d segments valid\n",
+			TABLE_SIZE, build_time * 1.0e6, distance_table.valid_segments(), TABLE_SIZE - 1);
+
+	for (int i = 0; i < LOOKUPS; i++){
+		inputs[i] = random_between(0.0f, 63.75f);
+	}
+	start = CycleCounter::reference_seconds();
+	for (int i = 0; i < LOOKUPS; i++){
+		sink = Winch::computeEncoderStepsFromDistance(inputs[i]);
+	}
+	double direct_time = CycleCounter::reference_seconds() - start;
+	start = CycleCounter::reference_seconds();
+	float steps = 0.0f;
+	for (int i = 0; i < LOOKUPS; i++){
+		distance_table.lookup(inputs[i], steps);
+		sink = steps;
+	}
+	double table_time = CycleCounter::reference_seconds() - start;
+	printf("  direct %.1f ns/call, table %.1f ns/call\n",
+			direct_time * 1.0e9 / LOOKUPS, table_time * 1.0e9 / LOOKUPS);
+
+	//angle -> steps, which is defined everywhere, to check interpolation error
+	InterpolatedTable<TABLE_SIZE> angle_table;
+	angle_table.build(Winch::computeEncoderStepsFromAngle, 0.0f, MAX_ANGLE);
+	for (int i = 0; i < LOOKUPS; i++){
+		inputs[i] = random_between(0.0f, MAX_ANGLE);
+	}
+	float max_error = 0.0f;
+	for (int i = 0; i < LOOKUPS; i++){
+		float direct = Winch::computeEncoderStepsFromAngle(inputs[i]);
+		if (angle_table.lookup(inputs[i], steps)){
+			float error = steps > direct ? steps - direct : direct - steps;
+			if (error > max_error){
+				max_error = error;
+			}
+		}
+	}
+	start = CycleCounter::reference_seconds();
+	for (int i = 0; i < LOOKUPS; i++){
+		sink = Winch::computeEncoderStepsFromAngle(inputs[i]);
+	}
+	direct_time = CycleCounter::reference_seconds() - start;
+	start = CycleCounter::reference_seconds();
+	for (int i = 0; i < LOOKUPS; i++){
+		angle_table.lookup(inputs[i], steps);
+		sink = steps;
+	}
+	table_time = CycleCounter::reference_seconds() - start;
+	printf("angle table: %d of %d segments valid, max error %.4f encoder steps\n",
+			angle_table.valid_segments(), TABLE_SIZE - 1, max_error);
+	printf("  direct %.1f ns/call, table %.1f ns/call\n",
+			direct_time * 1.0e9 / LOOKUPS, table_time * 1.0e9 / LOOKUPS);
+
+	delete [] inputs;
+	return 0;
+}
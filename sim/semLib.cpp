@@ -0,0 +1,66 @@
+#include "semLib.h"
+#include "sysLib.h"
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+struct sim_semaphore {
+	pthread_mutex_t lock;
+	pthread_cond_t available;
+	bool full;
+};
+
+static const int SIM_CLOCK_RATE = 1000;
+
+int sysClkRateGet(){
+	return SIM_CLOCK_RATE;
+}
+
+SEM_ID semBCreate(int options, SEM_B_STATE initialState){
+	SEM_ID sem = new sim_semaphore;
+	pthread_mutex_init(&sem->lock, NULL);
+	pthread_cond_init(&sem->available, NULL);
+	sem->full = initialState == SEM_FULL;
+	return sem;
+}
+
+SEM_ID semMCreate(int options){
+	return semBCreate(options, SEM_FULL);
+}
+
+STATUS semGive(SEM_ID sem){
+	pthread_mutex_lock(&sem->lock);
+	sem->full = true;
+	pthread_cond_signal(&sem->available);
+	pthread_mutex_unlock(&sem->lock);
+	return OK;
+}
+
+STATUS semTake(SEM_ID sem, int timeout){
+	struct timespec deadline;
+	if (timeout > 0){
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		long long ns = deadline.tv_nsec + (long long)timeout * (1000000000LL / SIM_CLOCK_RATE);
+		deadline.tv_sec += ns / 1000000000LL;
+		deadline.tv_nsec = ns % 1000000000LL;
+	}
+	pthread_mutex_lock(&sem->lock);
+	while (!sem->full && timeout != NO_WAIT){
+		if (timeout == WAIT_FOREVER){
+			pthread_cond_wait(&sem->available, &sem->lock);
+		} else if (pthread_cond_timedwait(&sem->available, &sem->lock, &deadline) == ETIMEDOUT){
+			break;
+		}
+	}
+	bool taken = sem->full;
+	sem->full = false;
+	pthread_mutex_unlock(&sem->lock);
+	return taken ? OK : ERROR;
+}
+
+STATUS semDelete(SEM_ID sem){
+	pthread_cond_destroy(&sem->available);
+	pthread_mutex_destroy(&sem->lock);
+	delete sem;
+	return OK;
+}
@@ -0,0 +1,27 @@
+#ifndef SIM_SEMLIB_H_
+#define SIM_SEMLIB_H_
+
+/*
+ * Host-side stand-in for the vxWorks semaphores the robot uses, on pthreads.
+ * Mutexes are plain binary semaphores here (no ownership, no recursion).
+ * Timeouts are in sysClkRateGet() ticks of real time.
+ */
+#include "vxWorks.h"
+
+typedef struct sim_semaphore * SEM_ID;
+typedef enum {SEM_EMPTY, SEM_FULL} SEM_B_STATE;
+
+#define WAIT_FOREVER (-1)
+#define NO_WAIT 0
+#define SEM_Q_FIFO 0x00
+#define SEM_Q_PRIORITY 0x01
+#define SEM_DELETE_SAFE 0x04
+#define SEM_INVERSION_SAFE 0x08
+
+SEM_ID semBCreate(int options, SEM_B_STATE initialState);
+SEM_ID semMCreate(int options);
+STATUS semGive(SEM_ID semId);
+STATUS semTake(SEM_ID semId, int timeout);
+STATUS semDelete(SEM_ID semId);
+
+#endif
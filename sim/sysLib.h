@@ -0,0 +1,9 @@
+#ifndef SIM_SYSLIB_H_
+#define SIM_SYSLIB_H_
+
+#include "vxWorks.h"
+
+//system clock ticks per second, the unit of vxWorks timeouts
+int sysClkRateGet();
+
+#endif
@@ -0,0 +1,300 @@
+/*
+ * Monte Carlo shot simulator, for calibrating the firing distance and the pull-back for it.
+ * Fires shots over a grid of distances and winch pull-backs. Each shot draws the catapult's
+ * uncertain constants (spring constant, ball and catapult mass, rest angle, ball height)
+ * at random around Winch's values, along with the rangefinder's error and how far short of
+ * its target the winch stops. It prints how often each cell goes in, the best pull-back at
+ * each distance and the distance with the best odds.
+ * The model is Winch's: steps to pull-back angle through the rope geometry
+ * (Winch::computeEncoderStepsFromAngle), the springs' energy (1/2 k angle^2) into the ball
+ * and the catapult arm, then a drag-free trajectory released at PI - REST_ANGLE.
+ * Cells are handed out to a pool of threads. Each cell's shots are sampled into arrays and
+ * then evaluated four at a time with GCC vector types. Every cell has its own seed, so the
+ * numbers don't depend on how many threads ran them.
+ *
+ *     g++ -std=gnu++98 -O2 -pthread -Isim -I2014robot sim/tools/ShotMonteCarlo.cpp \
+ *         sim/SimHAL.cpp sim/WPILib.cpp sim/semLib.cpp 2014robot/?*.cpp -o shotmontecarlo
+ *     ./shotmontecarlo [-n shots per cell] [-j threads] [-csv grid.csv] [-seed n]
+ */
+#include "Winch.h"
+#include "CycleCounter.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+//the grid
+static const float MIN_DISTANCE = 4.0f; //feet from the goal, like Winch's distances
+static const float MAX_DISTANCE = 40.0f;
+static const float DISTANCE_STEP = 0.5f;
+static const float MAX_PULL_ANGLE = 1.5f; //radians, about as far as the catapult goes
+static const int STEPS_STEP = 4; //encoder steps between pull-backs
+
+//how sure we are of Winch's constants; all uniform between the limits
+static const float SPRING_SPREAD = 0.15f; //fraction of SPRING_CONST either way
+static const float BALL_MASS_SPREAD = 0.05f; //fraction of BALL_MASS either way
+static const float MIN_CATAPULT_MASS = 0.5f; //kg; Winch says we can play with this one
+static const float MAX_CATAPULT_MASS = 2.0f;
+static const float REST_ANGLE_SPREAD = 0.05f; //radians either way
+static const float BALL_HEIGHT_SPREAD = 2.0f; //inches either way
+//and the robot's
+static const float RANGE_SIGMA = 1.0f; //inches, the rangefinder's noise (normal)
+static const float WIND_SHORTFALL = 4.0f; //steps; the winch stops up to its TARGET_TOLERANCE short
+
+//how far the ball's center can pass from the goal's center height and still go in
+static const float GOAL_TOLERANCE = 0.25f; //meters
+
+static const float METERS_PER_FOOT = 0.3048f;
+static const float METERS_PER_INCH = 0.0254f;
+
+static const int BATCH = 256; //shots sampled, then evaluated, at a time; a multiple of 4
+
+typedef float float4 __attribute__((vector_size(16)));
+typedef int int4 __attribute__((vector_size(16)));
+
+//pull-back angle for each whole encoder step, inverted from Winch's rope geometry
+static float * step_angles;
+static int max_steps;
+
+static int num_distances;
+static int num_pullbacks;
+static int shots_per_cell;
+static UINT32 seed;
+static UINT32 * hits; //per cell, distance-major
+static volatile int next_cell;
+
+//xorshift32, one per cell
+static inline float uniform(UINT32 &state){
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline float between(UINT32 &state, float min, float max){
+	return min + (max - min) * uniform(state);
+}
+
+//a sum of four uniforms, scaled; close enough to a normal for measurement noise
+static inline float normal(UINT32 &state, float sigma){
+	float sum = uniform(state) + uniform(state) + uniform(state) + uniform(state);
+	return (sum - 2.0f) * 1.7320508f * sigma;
+}
+
+static void build_step_angles(){
+	max_steps = (int)Winch::computeEncoderStepsFromAngle(MAX_PULL_ANGLE);
+	step_angles = new float[max_steps + 2];
+	for (int s = 0; s <= max_steps + 1; s++){
+		float low = 0.0f;
+		float high = 2.0f * MAX_PULL_ANGLE;
+		for (int i = 0; i < 32; i++){
+			float mid = 0.5f * (low + high);
+			if (Winch::computeEncoderStepsFromAngle(mid) < s){
+				low = mid;
+			} else {
+				high = mid;
+			}
+		}
+		step_angles[s] = 0.5f * (low + high);
+	}
+}
+
+static inline float angle_for_steps(float steps){
+	if (steps <= 0.0f){
+		return 0.0f;
+	}
+	int whole = (int)steps;
+	if (whole > max_steps){
+		return step_angles[max_steps + 1];
+	}
+	float fraction = steps - whole;
+	return step_angles[whole] + fraction * (step_angles[whole + 1] - step_angles[whole]);
+}
+
+/*
+ * Height of each shot's ball as it reaches the goal, compared with the goal's
+ * y = h + x tan(t) - g x^2 (1 + tan(t)^2) / (2 v^2), with v^2 = k angle^2 / mass
+ * Returns how many of the n (a multiple of 4) go in.
+ */
+static UINT32 count_hits(const float * angle, const float * spring, const float * mass, const float * slope,
+		const float * height, const float * distance, int n){
+	const float4 half_g = {-0.5f * Winch::GRAVITY, -0.5f * Winch::GRAVITY, -0.5f * Winch::GRAVITY,
+			-0.5f * Winch::GRAVITY};
+	const float goal_height = Winch::GOAL_HEIGHT;
+	const float4 goal = {goal_height, goal_height, goal_height, goal_height};
+	const float tolerance_squared = GOAL_TOLERANCE * GOAL_TOLERANCE;
+	const float4 tolerance = {tolerance_squared, tolerance_squared, tolerance_squared, tolerance_squared};
+	const float4 one = {1.0f, 1.0f, 1.0f, 1.0f};
+	int4 in = {0, 0, 0, 0};
+	for (int i = 0; i < n; i += 4){
+		float4 a, k, m, t, h, x;
+		memcpy(&a, angle + i, sizeof(a));
+		memcpy(&k, spring + i, sizeof(k));
+		memcpy(&m, mass + i, sizeof(m));
+		memcpy(&t, slope + i, sizeof(t));
+		memcpy(&h, height + i, sizeof(h));
+		memcpy(&x, distance + i, sizeof(x));
+		float4 v_squared = k * a * a / m;
+		float4 y = h + x * t - half_g * x * x * (one + t * t) / v_squared;
+		float4 miss = y - goal;
+		in -= (int4)(miss * miss < tolerance); //true is -1
+	}
+	return in[0] + in[1] + in[2] + in[3];
+}
+
+static void run_cell(int cell, float * batch){
+	float * angle = batch;
+	float * spring = batch + BATCH;
+	float * mass = batch + 2 * BATCH;
+	float * slope = batch + 3 * BATCH;
+	float * height = batch + 4 * BATCH;
+	float * distance = batch + 5 * BATCH;
+
+	float target_distance = (MIN_DISTANCE + (cell / num_pullbacks) * DISTANCE_STEP) * METERS_PER_FOOT;
+	float target_steps = (cell % num_pullbacks) * STEPS_STEP;
+	UINT32 state = seed ^ ((UINT32)cell * 0x9E3779B9u);
+	if (state == 0){
+		state = 1;
+	}
+	UINT32 in = 0;
+	for (int done = 0; done < shots_per_cell; done += BATCH){
+		int n = shots_per_cell - done < BATCH ? shots_per_cell - done : BATCH;
+		n = (n + 3) & ~3; //a few extra shots rather than a scalar tail
+		for (int i = 0; i < n; i++){
+			angle[i] = angle_for_steps(target_steps - between(state, 0.0f, WIND_SHORTFALL));
+			spring[i] = Winch::SPRING_CONST * Winch::NUM_SPRINGS * between(state, 1.0f - SPRING_SPREAD, 1.0f + SPRING_SPREAD);
+			mass[i] = Winch::BALL_MASS * between(state, 1.0f - BALL_MASS_SPREAD, 1.0f + BALL_MASS_SPREAD)
+					+ between(state, MIN_CATAPULT_MASS, MAX_CATAPULT_MASS);
+			float rest_angle = Winch::REST_ANGLE + between(state, -REST_ANGLE_SPREAD, REST_ANGLE_SPREAD);
+			slope[i] = tanf((float)Winch::PI - rest_angle);
+			height[i] = (Winch::BALL_HEIGHT + between(state, -BALL_HEIGHT_SPREAD, BALL_HEIGHT_SPREAD)) * METERS_PER_INCH;
+			distance[i] = target_distance + normal(state, RANGE_SIGMA) * METERS_PER_INCH;
+		}
+		in += count_hits(angle, spring, mass, slope, height, distance, n);
+	}
+	hits[cell] = in;
+}
+
+static void * worker(void *){
+	float * batch = new float[6 * BATCH];
+	int cells = num_distances * num_pullbacks;
+	while (true){
+		int cell = __sync_fetch_and_add(&next_cell, 1);
+		if (cell >= cells){
+			break;
+		}
+		run_cell(cell, batch);
+	}
+	delete [] batch;
+	return NULL;
+}
+
+static void usage(){
+	fprintf(stderr, "usage: shotmontecarlo [-n shots per cell] [-j threads] [-csv grid.csv] [-seed n]\n");
+	exit(1);
+}
+
+int main(int argc, char ** argv){
+	shots_per_cell = 10000;
+	int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	const char * csv_path = NULL;
+	seed = 830;
+	for (int i = 1; i < argc; i++){
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc){
+			shots_per_cell = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc){
+			threads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-csv") == 0 && i + 1 < argc){
+			csv_path = argv[++i];
+		} else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc){
+			seed = (UINT32)strtoul(argv[++i], NULL, 0);
+		} else {
+			usage();
+		}
+	}
+	if (shots_per_cell < 1 || threads < 1){
+		usage();
+	}
+
+	build_step_angles();
+	num_distances = (int)((MAX_DISTANCE - MIN_DISTANCE) / DISTANCE_STEP) + 1;
+	num_pullbacks = max_steps / STEPS_STEP + 1;
+	int cells = num_distances * num_pullbacks;
+	hits = new UINT32[cells];
+	next_cell = 0;
+
+	double start = CycleCounter::reference_seconds();
+	pthread_t * pool = new pthread_t[threads];
+	for (int i = 0; i < threads; i++){
+		pthread_create(&pool[i], NULL, worker, NULL);
+	}
+	for (int i = 0; i < threads; i++){
+		pthread_join(pool[i], NULL);
+	}
+	double elapsed = CycleCounter::reference_seconds() - start;
+	int rounded_shots = (shots_per_cell + 3) & ~3;
+	double total_shots = (double)cells * rounded_shots;
+	printf("%d distances x %d pull-backs, %d shots each: %.0f shots in %.2f s on %d threads (%.1f M shots/s)\n",
+			num_distances, num_pullbacks, rounded_shots, total_shots, elapsed, threads,
+			total_shots / elapsed * 1.0e-6);
+
+	FILE * csv = NULL;
+	if (csv_path != NULL){
+		csv = fopen(csv_path, "w");
+		if (csv == NULL){
+			perror(csv_path);
+			return 1;
+		}
+		fprintf(csv, "distance_ft,pullback_steps,p_hit\n");
+	}
+
+	printf("%8s %8s %7s %15s %8s\n", "feet", "steps", "p(hit)", "steps >= 90%", "table");
+	float best_p = -1.0f;
+	float best_distance = 0.0f;
+	int best_steps = 0;
+	for (int d = 0; d < num_distances; d++){
+		float feet = MIN_DISTANCE + d * DISTANCE_STEP;
+		const UINT32 * row = hits + d * num_pullbacks;
+		int best = 0;
+		for (int p = 0; p < num_pullbacks; p++){
+			if (row[p] > row[best]){
+				best = p;
+			}
+			if (csv != NULL){
+				fprintf(csv, "%.2f,%d,%.5f\n", feet, p * STEPS_STEP, row[p] / (double)rounded_shots);
+			}
+		}
+		float p_hit = row[best] / (float)rounded_shots;
+		//the range of pull-backs nearly as good as the best, ie how much slop there is
+		int low = best;
+		int high = best;
+		while (low > 0 && row[low - 1] >= 0.9f * row[best]){
+			low--;
+		}
+		while (high + 1 < num_pullbacks && row[high + 1] >= 0.9f * row[best]){
+			high++;
+		}
+		char band[32];
+		snprintf(band, sizeof(band), "%d-%d", low * STEPS_STEP, high * STEPS_STEP);
+		float table_steps = Winch::computeEncoderStepsFromDistance(feet);
+		if (table_steps == table_steps){
+			printf("%8.1f %8d %7.3f %15s %8.1f\n", feet, best * STEPS_STEP, p_hit, band, table_steps);
+		} else {
+			printf("%8.1f %8d %7.3f %15s %8s\n", feet, best * STEPS_STEP, p_hit, band, "-");
+		}
+		if (p_hit > best_p){
+			best_p = p_hit;
+			best_distance = feet;
+			best_steps = best * STEPS_STEP;
+		}
+	}
+	if (csv != NULL){
+		fclose(csv);
+	}
+	printf("best: %.1f ft (%.0f in) from the goal, pulled back %d steps, %.1f%% of shots go in\n",
+			best_distance, best_distance * 12.0f, best_steps, best_p * 100.0f);
+	printf("(\"table\" is what Winch's shot table would pull back; - where its closed form has no answer)\n");
+	return 0;
+}
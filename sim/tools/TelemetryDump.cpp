@@ -0,0 +1,113 @@
+/*
+ * Prints a telemetry log (see 2014robot/TelemetryFormat.h) as text, one line per cycle.
+ * Maps the log and its index, and with -t starts at the key record before that time
+ * rather than decoding from the start.
+ *
+ *     g++ -std=gnu++98 -O2 -Isim -I2014robot sim/tools/TelemetryDump.cpp 2014robot/TelemetryFormat.cpp \
+ *         -o telemetrydump
+ *     ./telemetrydump telemetry.log telemetry.idx [-t seconds] [-n records]
+ */
+#include "TelemetryFormat.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace TelemetryFormat;
+
+static const UINT8 * map_file(const char * path, size_t &size){
+	int fd = open(path, O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0){
+		perror(path);
+		exit(1);
+	}
+	size = st.st_size;
+	if (size == 0){
+		close(fd);
+		return NULL;
+	}
+	void * data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED){
+		perror(path);
+		exit(1);
+	}
+	return (const UINT8 *)data;
+}
+
+int main(int argc, char **argv){
+	if (argc < 3){
+		fprintf(stderr, "usage: %s log index [-t seconds] [-n records]\n", argv[0]);
+		return 1;
+	}
+	double start_time = -1.0;
+	long max_records = -1;
+	for (int i = 3; i + 1 < argc; i += 2){
+		if (strcmp(argv[i], "-t") == 0){
+			start_time = atof(argv[i + 1]);
+		} else if (strcmp(argv[i], "-n") == 0){
+			max_records = atol(argv[i + 1]);
+		}
+	}
+
+	size_t log_size, index_size;
+	const UINT8 * log = map_file(argv[1], log_size);
+	const index_entry * index = (const index_entry *)map_file(argv[2], index_size);
+	int entries = index_size / sizeof(index_entry);
+	if (log_size < sizeof(log_header) || memcmp(log, "T83C", 4) != 0 || log[4] != VERSION){
+		fprintf(stderr, "%s isn't a version %u telemetry log\n", argv[1], VERSION);
+		return 1;
+	}
+
+	//the last key record at or before the start time
+	UINT32 offset = sizeof(log_header);
+	UINT32 record_number = 0;
+	if (start_time >= 0.0 && entries > 0){
+		UINT32 target = (UINT32)(start_time * 1.0e6 / TIME_UNIT);
+		int lo = 0, hi = entries - 1;
+		while (lo < hi){
+			int mid = (lo + hi + 1) / 2;
+			UINT32 time, o, n;
+			read_index_entry(index[mid], time, o, n);
+			if (time <= target){
+				lo = mid;
+			} else {
+				hi = mid - 1;
+			}
+		}
+		UINT32 time;
+		read_index_entry(index[lo], time, offset, record_number);
+	}
+
+	RecordDecoder decoder;
+	decoder.seek_to_key(record_number);
+	const UINT8 * p = log + offset;
+	const UINT8 * end = log + log_size;
+	long printed = 0;
+	record r;
+	int used;
+	printf("#%9s %10s %6s %6s %7s %5s %5s %4s %4s %4s %4s %4s %4s %4s %4s %3s %4s\n", "record", "time",
+			"arm", "winch", "range", "pbtn", "cbtn", "sw", "fl", "fr", "rl", "rr", "roll", "arm", "wnch", "sol", "mode");
+	while (p < end && max_records != printed && (used = decoder.decode(p, end, r)) > 0){
+		p += used;
+		if (start_time >= 0.0 && r.timestamp * 1.0e-6 < start_time){
+			record_number++;
+			continue;
+		}
+		printf("%10u %10.4f %6d %6d %7.1f %5x %5x %4x %4d %4d %4d %4d %4d %4d %4d %3x %4u\n", record_number,
+				r.timestamp * 1.0e-6, r.arm_encoder, r.winch_encoder, r.range, r.pilot_buttons, r.copilot_buttons,
+				r.switches, r.outputs[0], r.outputs[1], r.outputs[2], r.outputs[3], r.outputs[4], r.outputs[5],
+				r.outputs[6], r.solenoids, r.mode);
+		record_number++;
+		printed++;
+	}
+	if (start_time < 0.0 && max_records < 0){
+		fprintf(stderr, "%u records, %lu bytes, %.2f bytes per record, %d index entries\n", record_number,
+				(unsigned long)log_size, record_number ? (double)log_size / record_number : 0.0, entries);
+	}
+	return 0;
+}
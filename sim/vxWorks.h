@@ -0,0 +1,28 @@
+#ifndef SIM_VXWORKS_H_
+#define SIM_VXWORKS_H_
+
+/*
+ * Host-side stand-in for the handful of vxWorks types WPILib and our code use.
+ * Sizes match the cRIO (PPC603, 32 bit) so packed structs come out the same.
+ */
+#include <stddef.h> //NULL, which the real vxWorks.h defines
+
+typedef signed char INT8;
+typedef unsigned char UINT8;
+typedef short INT16;
+typedef unsigned short UINT16;
+typedef int INT32;
+typedef unsigned int UINT32;
+typedef long long INT64;
+typedef unsigned long long UINT64;
+typedef int STATUS;
+typedef int (*FUNCPTR)(...);
+
+#ifndef OK
+#define OK 0
+#endif
+#ifndef ERROR
+#define ERROR (-1)
+#endif
+
+#endif